@@ -0,0 +1,48 @@
+#version 460 core
+
+layout (location = 0) in vec3 inPosition;
+layout (location = 1) in vec3 inNormals;
+layout (location = 2) in vec2 inTextureCoordinates;
+
+// per-instance attributes follow the three vertex attributes
+layout (location = 3) in mat4 inModel;
+layout (location = 7) in vec3 inTint;
+layout (location = 8) in float inLayer;
+
+out vec2 textureCoordinates;
+out vec3 transposedNormals;
+out vec3 fragmentPosition;
+out vec3 lightColour;
+out vec3 objectColour;
+flat out float layer;
+
+// per-frame values shared by every object, see FrameData.h
+layout (std140, binding = 0) uniform FrameData
+{
+	mat4 uView;
+	mat4 uProjection;
+	vec4 uLightPosition;
+	vec4 uLightColour;
+	vec4 uViewPosition;
+};
+
+// maps quantized mesh positions back into model space
+uniform mat4 uDequantize = mat4(1.0f);
+
+void main()
+{   
+	vec4 position = uDequantize * vec4(inPosition, 1.0f);
+
+	gl_Position = uProjection * uView * inModel * position;
+	
+	fragmentPosition = vec3(inModel * position);
+	
+	// bricks and balls are scaled uniformly, so the model matrix only changes the normals' length
+	transposedNormals = mat3(inModel) * inNormals;
+	
+	textureCoordinates = inTextureCoordinates;
+	
+	lightColour = uLightColour.rgb;
+	objectColour = inTint;
+	layer = inLayer;
+}
\ No newline at end of file
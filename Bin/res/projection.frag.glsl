@@ -6,8 +6,15 @@ in vec3 transposedNormals;
 in vec3 fragmentPosition;
 in vec3 lightColour;
 
-uniform vec3 uLightPosition; 
-uniform vec3 uViewPosition; 
+layout (std140, binding = 0) uniform FrameData
+{
+	mat4 uView;
+	mat4 uProjection;
+	vec4 uLightPosition;
+	vec4 uLightColour;
+	vec4 uViewPosition;
+};
+
 uniform vec3 uObjectColour;
 uniform sampler2D uTexture;
 
@@ -20,7 +27,7 @@ void main()
     // diffuse light component
 	float diffuseCoefficient = 0.8f;	
     vec3 normalizedNormal = normalize(transposedNormals);
-    vec3 lightDirection = normalize(uLightPosition - fragmentPosition);
+    vec3 lightDirection = normalize(uLightPosition.xyz - fragmentPosition);
     float diffuseMax = max(dot(normalizedNormal, lightDirection), 0.0);
     vec3 diffuse = diffuseCoefficient * diffuseMax * lightColour;
 
@@ -0,0 +1,250 @@
+#include "GLStateCache.h"
+
+#include <glad/glad.h>
+
+namespace
+{
+	// never a valid value of any cached state, so the first call always reaches GL
+	const unsigned unknown = ~0u;
+
+	const unsigned maxTextureUnits = 16;
+
+	struct TextureUnit
+	{
+		unsigned texture2D = unknown;
+		unsigned textureArray = unknown;
+	};
+
+	struct State
+	{
+		unsigned program = unknown;
+		unsigned vao = unknown;
+		unsigned arrayBuffer = unknown;
+		unsigned uniformBuffer = unknown;
+		unsigned activeUnit = unknown;
+		TextureUnit units[maxTextureUnits];
+
+		unsigned blend = unknown;
+		unsigned depthTest = unknown;
+		unsigned cullFace = unknown;
+
+		unsigned blendSource = unknown;
+		unsigned blendDestination = unknown;
+		unsigned cullFaceMode = unknown;
+		unsigned frontFace = unknown;
+	};
+
+	State state;
+
+	unsigned issued = 0;
+	unsigned elided = 0;
+
+	// stores the value and returns true when it differs from the cached one
+	bool Update(unsigned& cached, unsigned value)
+	{
+		if (cached == value)
+		{
+			elided++;
+			return false;
+		}
+
+		cached = value;
+		issued++;
+
+		return true;
+	}
+
+	unsigned* CachedCapability(unsigned capability)
+	{
+		switch (capability)
+		{
+		case GL_BLEND:
+			return &state.blend;
+
+		case GL_DEPTH_TEST:
+			return &state.depthTest;
+
+		case GL_CULL_FACE:
+			return &state.cullFace;
+		}
+
+		return nullptr;
+	}
+}
+
+void GLStateCache::UseProgram(unsigned program)
+{
+	if (Update(state.program, program))
+	{
+		glUseProgram(program);
+	}
+}
+
+void GLStateCache::BindVertexArray(unsigned vao)
+{
+	if (Update(state.vao, vao))
+	{
+		glBindVertexArray(vao);
+	}
+}
+
+void GLStateCache::BindBuffer(unsigned target, unsigned buffer)
+{
+	unsigned* cached = target == GL_ARRAY_BUFFER ? &state.arrayBuffer
+		: target == GL_UNIFORM_BUFFER ? &state.uniformBuffer
+		: nullptr;
+
+	if (!cached)
+	{
+		issued++;
+		glBindBuffer(target, buffer);
+	}
+	else if (Update(*cached, buffer))
+	{
+		glBindBuffer(target, buffer);
+	}
+}
+
+void GLStateCache::BindBufferRange(unsigned target, unsigned index, unsigned buffer, unsigned offset, unsigned size)
+{
+	issued++;
+	glBindBufferRange(target, index, buffer, offset, size);
+
+	// GL_ARRAY_BUFFER is not an indexed target, so only the uniform binding can change here
+	if (target == GL_UNIFORM_BUFFER)
+	{
+		state.uniformBuffer = buffer;
+	}
+}
+
+void GLStateCache::BindTexture(unsigned unit, unsigned target, unsigned texture)
+{
+	if (unit >= maxTextureUnits || (target != GL_TEXTURE_2D && target != GL_TEXTURE_2D_ARRAY))
+	{
+		issued += 2;
+		state.activeUnit = unit;
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(target, texture);
+		return;
+	}
+
+	TextureUnit& cached = state.units[unit];
+
+	// the unit is made active even when it already holds the texture, Texture::SetImage relies on that to
+	// upload to the texture it just bound
+	if (Update(state.activeUnit, unit))
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+	}
+
+	if (Update(target == GL_TEXTURE_2D ? cached.texture2D : cached.textureArray, texture))
+	{
+		glBindTexture(target, texture);
+	}
+}
+
+void GLStateCache::SetEnabled(unsigned capability, bool enabled)
+{
+	unsigned* cached = CachedCapability(capability);
+
+	if (cached && !Update(*cached, enabled))
+	{
+		return;
+	}
+
+	if (!cached)
+	{
+		issued++;
+	}
+
+	if (enabled)
+	{
+		glEnable(capability);
+	}
+	else
+	{
+		glDisable(capability);
+	}
+}
+
+void GLStateCache::BlendFunc(unsigned source, unsigned destination)
+{
+	if (state.blendSource == source && state.blendDestination == destination)
+	{
+		elided++;
+		return;
+	}
+
+	state.blendSource = source;
+	state.blendDestination = destination;
+	issued++;
+
+	glBlendFunc(source, destination);
+}
+
+void GLStateCache::CullFace(unsigned face)
+{
+	if (Update(state.cullFaceMode, face))
+	{
+		glCullFace(face);
+	}
+}
+
+void GLStateCache::FrontFace(unsigned winding)
+{
+	if (Update(state.frontFace, winding))
+	{
+		glFrontFace(winding);
+	}
+}
+
+void GLStateCache::ForgetTexture(unsigned texture)
+{
+	// GL unbinds a deleted texture from every unit
+	for (TextureUnit& unit : state.units)
+	{
+		if (unit.texture2D == texture)
+		{
+			unit.texture2D = 0;
+		}
+
+		if (unit.textureArray == texture)
+		{
+			unit.textureArray = 0;
+		}
+	}
+}
+
+void GLStateCache::ForgetBuffer(unsigned buffer)
+{
+	if (state.arrayBuffer == buffer)
+	{
+		state.arrayBuffer = 0;
+	}
+
+	if (state.uniformBuffer == buffer)
+	{
+		state.uniformBuffer = 0;
+	}
+}
+
+void GLStateCache::Invalidate()
+{
+	state = State();
+}
+
+unsigned GLStateCache::GetIssued()
+{
+	return issued;
+}
+
+unsigned GLStateCache::GetElided()
+{
+	return elided;
+}
+
+void GLStateCache::ResetCounters()
+{
+	issued = 0;
+	elided = 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+// Shadows the GL binding and capability state so repeated binds of the same object are dropped.
+// Every bind in the renderer goes through here, code that calls GL directly has to call Invalidate afterwards.
+class GLStateCache
+{
+public:
+	static void UseProgram(unsigned program);
+	static void BindVertexArray(unsigned vao);
+
+	// GL_ARRAY_BUFFER and GL_UNIFORM_BUFFER are cached, the element buffer belongs to the bound vertex array
+	static void BindBuffer(unsigned target, unsigned buffer);
+
+	// glBindBufferRange also replaces the generic binding of the target, so it is recorded here
+	static void BindBufferRange(unsigned target, unsigned index, unsigned buffer, unsigned offset, unsigned size);
+
+	// selects the unit, even when it already holds the texture, and binds GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY to it
+	static void BindTexture(unsigned unit, unsigned target, unsigned texture);
+
+	// GL_BLEND, GL_DEPTH_TEST or GL_CULL_FACE
+	static void SetEnabled(unsigned capability, bool enabled);
+
+	static void BlendFunc(unsigned source, unsigned destination);
+	static void CullFace(unsigned face);
+	static void FrontFace(unsigned winding);
+
+	// a deleted name can be handed out again, so it must not stay cached as bound
+	static void ForgetTexture(unsigned texture);
+	static void ForgetBuffer(unsigned buffer);
+
+	// forgets everything, the next call of each kind always reaches GL
+	static void Invalidate();
+
+	static unsigned GetIssued();
+	static unsigned GetElided();
+	static void ResetCounters();
+};
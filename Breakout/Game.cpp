@@ -1,5 +1,7 @@
 #include "Game.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <filesystem>
@@ -9,14 +11,15 @@
 #include <GLFW/glfw3.h>
 
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include "camera.h"
+#include "GLStateCache.h"
+#include "ProgramCache.h"
 #include "Shader.h"
 
-#include "models/Ball.h"
-#include "models/Brick.h"
 #include "models/Player.h"
 #include "models/GameObject.h"
 #include "models/Sprite.h"
@@ -27,23 +30,13 @@ bool updateView;
 int screenWidth = 1270;
 int screenHeight = 720;
 
-bool stuckToPaddle;
-float offset = 0;
+// perspective clip planes, the far plane also scales the depth part of the sort keys
+const float nearPlane = 0.1f;
+const float farPlane = 1000.0f;
 
-int score;
-
-// bricks
-const unsigned numbBricksHigh = 5;
-const unsigned numbBricksWide = 10;
+// wall blocks along each side and the top
 const unsigned boundBlocks = 20;
 const unsigned topBlocks = 25;
-std::unique_ptr<Brick> bricks[numbBricksHigh][numbBricksWide];
-std::unique_ptr<Brick> boundLeft[boundBlocks];
-std::unique_ptr<Brick> boundRight[boundBlocks];
-std::unique_ptr<Brick> boundTop[topBlocks];
-
-std::vector<std::unique_ptr<Texture>> scoreText;
-std::vector<std::unique_ptr<Sprite>> scoreObject;
 
 glm::mat4 orthoProgMatrix;
 glm::mat4 orthoViewMatrix;
@@ -51,11 +44,21 @@ glm::mat4 modelTranslate;
 glm::mat4 modelScale;
 glm::mat4 modelRotation;
 
-bool finishGame;
-
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
+// score is zero padded to this many digits
+const size_t scoreDigits = 3;
+
+// seconds between the culling counts written to the log
+const double cullingReportInterval = 5.0;
+
+// linked program binaries, next to res in the working directory the assets are loaded from
+const char* const shaderCacheDirectory = "shadercache";
+
+// bytes of the ring buffer each frame may use, room for tens of thousands of instances
+const unsigned frameRingRegionSize = 4 * 1024 * 1024;
+
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
 	glViewport(0, 0, width, height);
@@ -106,7 +109,7 @@ void Game::Run()
 
 		camera->UpdateVectors();
 
-		Update(deltaTime);
+		Update();
 
 		Render();
 
@@ -114,35 +117,67 @@ void Game::Run()
 		glfwPollEvents();
 	}
 
+	Shutdown();
+
 	glfwTerminate();
 }
 
+void Game::Shutdown()
+{
+	simulation->Stop();
+
+	// GL objects have to be released while the context is still current
+	scoreLabel.reset();
+	scoreTitle.reset();
+	glyphs.reset();
+
+	background.reset();
+	player.reset();
+	lives.reset();
+	win.reset();
+	gameover.reset();
+
+	brickRenderer.reset();
+	indirectBrickRenderer.reset();
+	ballRenderer.reset();
+	spriteBatch.reset();
+	meshCache.reset();
+	textureCache.reset();
+	textureLoader.reset();
+	frameRing.reset();
+}
+
 void Game::Init()
 {
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_FRONT);
-	glFrontFace(GL_CW);
+	GLStateCache::SetEnabled(GL_BLEND, true);
+	GLStateCache::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLStateCache::SetEnabled(GL_CULL_FACE, true);
+	GLStateCache::CullFace(GL_FRONT);
+	GLStateCache::FrontFace(GL_CW);
 	
-	state = GameState::Play;
-	finishGame = false;
-
 	updateView = false;
 
-	stuckToPaddle = true;
+	simulation = std::make_unique<SimulationThread>();
+	snapshot = &simulation->GetLatest();
+	displayedScore = 0;
 
-	score = 0;
+	ProgramCache::SetDirectory(shaderCacheDirectory);
 
 	shader = std::make_unique<Shader>("res\\projection.vert.glsl", "res\\projection.frag.glsl");
+	uniformScaleShader = std::make_unique<Shader>("res\\projection.vert.glsl", "res\\projection.frag.glsl", std::vector<std::string>{ "UNIFORM_SCALE" });
 	spriteShader = std::make_unique<Shader>("res\\spriteProjection.vert.glsl", "res\\spriteProjection.frag.glsl");
+
+	meshCache = std::make_unique<MeshCache>();
+	textureLoader = std::make_unique<TextureLoader>();
+	textureCache = std::make_unique<TextureCache>(textureLoader.get());
+
+	frameRing = std::make_unique<DynamicRingBuffer>(frameRingRegionSize);
 	
 	{
 		background = std::make_unique<GameObject>();
-		background->loadASSIMP("res\\mesh\\backg.obj");
-		background->setBuffers();
+		background->mesh = meshCache->Load("res\\mesh\\backg.obj");
 
-		background->texture.Load("res\\content\\skymap.png");
+		background->texture = textureCache->Load("res\\content\\skymap.png");
 		
 		background->position = glm::vec3(0.0f);
 		background->scale = glm::vec3(100.0f);
@@ -150,41 +185,30 @@ void Game::Init()
 
 	{
 		player = std::make_unique<Player>();
-		player->loadASSIMP("res\\mesh\\player.obj");
-		player->setBuffers();
-
-		player->position = glm::vec3(0.0f, -9.5f, 0.0f);
-		player->scale = glm::vec3(1.5f, 0.125f, 0.5f);
-		
-		offset = player->scale.x;
+		player->mesh = meshCache->Load("res\\mesh\\player.obj");
 
-		player->texture.Load("res\\content\\player.png");
+		player->texture = textureCache->Load("res\\content\\player.png");
 	}
 
 	{
-		ball = std::make_unique<Ball>();
-		ball->loadASSIMP("res\\mesh\\sphere.obj");
-		ball->setBuffers();
-
-		ball->position = glm::vec3
-		(
-			player->position.x,
-			player->position.y + ball->scale.y,
-			player->position.z
-		);
-		
-		ball->scale = glm::vec3(0.1f, 0.1f, 0.1f);
-
-		ball->texture.Load("res\\content\\ball.png");
+		ballRenderer = std::make_unique<BallRenderer>(*meshCache, *textureCache, *frameRing);
 	}
 
 	{
+		if (GLAD_GL_VERSION_4_3)
+		{
+			indirectBrickRenderer = std::make_unique<IndirectBrickRenderer>(*meshCache, *textureCache, *frameRing);
+		}
+		else
+		{
+			brickRenderer = std::make_unique<BrickRenderer>(*meshCache, *textureCache, *frameRing);
+		}
+
 		BuildLevel();
 	}
 
 	{
 		lives = std::make_unique<Sprite>();
-		lives->SetBuffers();
 		
 		lives->scale = glm::vec3(30.0f, 30.0f, 1.0f);
 		lives->position = glm::vec3
@@ -194,12 +218,11 @@ void Game::Init()
 			0.0f
 		);
 
-		lives->texture.Load("res\\content\\heart.png");
+		lives->texture = textureCache->Load("res\\content\\heart.png");
 	}
 
 	{
 		win = std::make_unique<Sprite>();
-		win->SetBuffers();
 		
 		win->scale = glm::vec3(screenWidth / 2, screenHeight / 2, 1.0f);
 		win->position = glm::vec3
@@ -209,13 +232,12 @@ void Game::Init()
 			0.0f
 		);
 		
-		win->texture.Load("res\\content\\reward.png");
+		win->texture = textureCache->Load("res\\content\\reward.png");
 		win->active = false;
 	}
 	
 	{
 		gameover = std::make_unique<Sprite>();
-		gameover->SetBuffers();
 		
 		gameover->scale = glm::vec3(screenWidth / 2, screenHeight / 2, 1.0f);
 		gameover->position = glm::vec3
@@ -225,16 +247,27 @@ void Game::Init()
 			0.0f
 		);
 		
-		gameover->texture.Load("res\\content\\punish.png");
+		gameover->texture = textureCache->Load("res\\content\\punish.png");
 		gameover->active = false;
 	}
 
 	LoadScore();
 
-	glEnable(GL_DEPTH_TEST);
+	spriteBatch = std::make_unique<SpriteBatch>();
+	builtHud = HudState();
+
+	GLStateCache::SetEnabled(GL_DEPTH_TEST, true);
+
+	const ProgramCache::Stats& programs = ProgramCache::GetStats();
+
+	std::cout << "Shaders: " << programs.loaded << " loaded from the cache in " << programs.loadSeconds * 1000.0 << " ms, "
+		<< programs.compiled << " compiled in " << programs.compileSeconds * 1000.0 << " ms" << std::endl;
+
+	// started last so loading the assets does not count as time the simulation has to catch up on
+	simulation->Start();
 }
 
-void Game::Update(float dt)
+void Game::Update()
 {
 	orthoViewMatrix = glm::mat4(1.0f);
 	
@@ -245,20 +278,29 @@ void Game::Update(float dt)
 	spriteShader->setFloatMat4("uProjection", orthoProgMatrix);
 	spriteShader->unuse();
 	
-	if (state == GameState::Play)
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 	{
-		finishGame = IsGameFinished();
-		
-		if (finishGame)
-		{
-			state = GameState::Win;
-		}
+		glfwSetWindowShouldClose(window, true);
+	}
+
+	SimulationInput input;
+	input.left = glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS;
+	input.right = glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS;
+	input.launch = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+
+	simulation->SetInput(input);
 
-		UpdatePlayerPosition();
+	// the simulation steps at its own rate, the frame just draws whatever it last published
+	snapshot = &simulation->GetLatest();
 
-		UpdateBallPosition();
+	if (snapshot->score != displayedScore)
+	{
+		SetScore();
 	}
-	else if (state == GameState::Win)
+
+	const GameState state = snapshot->state;
+
+	if (state == GameState::Win)
 	{
 		win->active = true;
 	}
@@ -273,504 +315,245 @@ void Game::Render()
 	glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	shader->use();
+	// issued and elided state changes are counted per frame
+	GLStateCache::ResetCounters();
+
+	frameRing->BeginFrame();
+
+	// images decoded since the last frame replace their placeholders
+	textureLoader->Update();
 	
 	glm::mat4 rotationMat(1);
 	rotationMat = glm::rotate(rotationMat, _lightRotation, glm::vec3(1.0f, 1.0f, 0.0f));
 	_lightPos = glm::vec3(rotationMat * glm::vec4(_lightPos, 1.0));
+
+	const FrameData frame =
+	{
+		camera->GetViewMatrix(),
+		glm::perspective(glm::radians(90.0f), (float)screenWidth / (float)screenHeight, nearPlane, farPlane),
+		glm::vec4(_lightPos, 1.0f),
+		glm::vec4(_lightColour, 1.0f),
+		glm::vec4(camera->Position, 1.0f)
+	};
+
+	const auto frameAllocation = frameRing->Allocate(sizeof(FrameData), frameRing->GetUniformAlignment());
+
+	if (frameAllocation.data)
+	{
+		memcpy(frameAllocation.data, &frame, sizeof(FrameData));
+		GLStateCache::BindBufferRange(GL_UNIFORM_BUFFER, frameDataBinding, frameRing->GetID(), frameAllocation.offset, sizeof(FrameData));
+	}
+
+	const Frustum frustum(frame.projection * frame.view);
+
+	renderQueue.Begin();
+	visibleObjects = 0;
+	culledObjects = 0;
 	
 	ResetMatrices();
 	modelTranslate = translate(modelTranslate, glm::vec3(background->position.x, background->position.y, background->position.z));
 	modelScale = scale(modelScale, glm::vec3(background->scale.x, background->scale.y, background->scale.z));
 	modelRotation = rotate(modelRotation, background->rotation += deltaTime / 8, glm::vec3(0.0f, 1.0f, 0.0f));
 
-	RenderObject(shader, modelTranslate, modelScale, modelRotation, background->colour, background->texture);
-	background->render();
+	SubmitObject(*background, modelTranslate * modelScale * modelRotation, background->colour, *background->texture, frustum);
 	
+	const PaddleState& paddle = snapshot->paddle;
+
 	ResetMatrices();
-	modelTranslate = translate(modelTranslate, glm::vec3(player->position.x, player->position.y, player->position.z));
-	modelScale = scale(modelScale, glm::vec3(player->scale.x, player->scale.y, player->scale.z));
+	modelTranslate = translate(modelTranslate, paddle.position);
+	modelScale = scale(modelScale, paddle.scale);
 	modelRotation = glm::rotate(modelRotation, player->rotation, glm::vec3(0.0f, 1.0f, 0.0f));
 
-	RenderObject(shader, modelTranslate, modelRotation, modelScale, player->colour, player->texture);
-	player->render();
+	SubmitObject(*player, modelTranslate * modelRotation * modelScale, player->colour, *player->texture, frustum);
 	
-	ResetMatrices();
-	modelTranslate = translate(modelTranslate, ball->position);
-	modelRotation = glm::rotate(modelRotation, 0.0f, glm::vec3(0.0f, 1.0f, 0.0f));
-	modelScale = scale(modelScale, ball->scale);
+	ballRenderer->Begin();
 
-	RenderObject(shader, modelTranslate, modelRotation, modelScale, ball->colour, ball->texture);
-	ball->render();
-	
-	for (int y = 0; y < numbBricksHigh; y++)
-	{
-		for (int x = 0; x < numbBricksWide; x++)
-		{
-			ResetMatrices();
-			modelTranslate = translate(modelTranslate, bricks[y][x]->position);
-			modelScale = scale(modelScale, bricks[y][x]->scale);
-			modelRotation = rotate(modelRotation, bricks[y][x]->rotation += deltaTime, glm::vec3(0.0f, 1.0f, 0.0f));
-			
-			RenderObject(shader, modelTranslate, modelRotation, modelScale, bricks[y][x]->colour, bricks[y][x]->texture);
-			bricks[y][x]->render();
-		}
-	}
+	ballRenderer->Submit(snapshot->balls, _ballColour);
+	ballRenderer->Submit(snapshot->powerUps, _powerUpColour);
 
-	for (int i = 0; i < boundBlocks; i++)
-	{
-		ResetMatrices();
-		modelTranslate = translate(modelTranslate, boundLeft[i]->position);
-		modelScale = scale(modelScale, boundLeft[i]->scale);
-		modelRotation = rotate(modelRotation, boundLeft[i]->rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+	ballRenderer->Cull(frustum, camera->Position, frame.projection[1][1]);
+	ballRenderer->Flush(renderQueue);
 
-		RenderObject(shader, modelTranslate, modelRotation, modelScale, boundLeft[i]->colour, boundLeft[i]->texture);
-		boundLeft[i]->render();
-	}
+	visibleObjects += ballRenderer->GetInstanceCount();
+	culledObjects += ballRenderer->GetCulledCount();
 
-	for (int i = 0; i < boundBlocks; i++)
+	if (indirectBrickRenderer)
 	{
-		ResetMatrices();
-		modelTranslate = translate(modelTranslate, boundRight[i]->position);
-		modelScale = scale(modelScale, boundRight[i]->scale);
-		modelRotation = rotate(modelRotation, boundRight[i]->rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+		// culled on the GPU, see the Dispatch below
+		indirectBrickRenderer->Begin();
 
-		RenderObject(shader, modelTranslate, modelRotation, modelScale, boundRight[i]->colour, boundRight[i]->texture);
-		boundRight[i]->render();
-	}
+		indirectBrickRenderer->Submit(snapshot->bricks);
+		indirectBrickRenderer->Submit(walls);
 
-	for (int i = 0; i < topBlocks; i++)
+		indirectBrickRenderer->Flush(renderQueue);
+	}
+	else
 	{
-		ResetMatrices();
-		modelTranslate = translate(modelTranslate, boundTop[i]->position);
-		modelScale = scale(modelScale, boundTop[i]->scale);
-		modelRotation = rotate(modelRotation, boundTop[i]->rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+		brickRenderer->Begin();
 
-		RenderObject(shader, modelTranslate, modelRotation, modelScale, boundTop[i]->colour, boundTop[i]->texture);
-		boundTop[i]->render();
-	}
+		brickRenderer->Submit(snapshot->bricks);
+		brickRenderer->Submit(walls);
 
-	shader->unuse();
-	
-	glDisable(GL_DEPTH_TEST);
-	
-	spriteShader->use();
-	
-	{
-		for (int i = 0; i < player->lives; i++)
-		{
-			ResetMatrices();
-			
-			modelTranslate = glm::translate(modelTranslate, glm::vec3(lives->position.x + (i * 40.0f), lives->position.y, lives->position.z));
-			modelScale = glm::scale(modelScale, lives->scale);
+		brickRenderer->Cull(frustum, camera->Position, frame.projection[1][1]);
+		brickRenderer->Flush(renderQueue);
 
-			RenderSprite(spriteShader, modelTranslate, modelScale, lives->colour, lives->texture);
-			lives->Render();
-		}
+		visibleObjects += brickRenderer->GetInstanceCount();
+		culledObjects += brickRenderer->GetCulledCount();
 	}
 
+	const HudState hud = { paddle.lives, displayedScore, win->active, gameover->active };
+
+	if (hud != builtHud)
 	{
-		if (win->active)
-		{
-			ResetMatrices();
-			
-			modelTranslate = glm::translate(modelTranslate, win->position);
-			modelScale = glm::scale(modelScale, win->scale);
+		builtHud = hud;
+		BuildHud();
+	}
 
-			RenderSprite(spriteShader, modelTranslate, modelScale, win->colour, win->texture);
-			win->Render();
-		}
+	spriteBatch->Draw(renderQueue, *spriteShader);
 
-		if (gameover->active)
-		{
-			ResetMatrices();
-			
-			modelTranslate = glm::translate(modelTranslate, gameover->position);
-			modelScale = glm::scale(modelScale, gameover->scale);
-			
-			RenderSprite(spriteShader, modelTranslate, modelScale, gameover->colour, gameover->texture);
-			gameover->Render();
-		}
-	}
+	frameRing->Commit();
 
+	if (indirectBrickRenderer)
 	{
-		for (auto& sprite : scoreObject)
-		{
-			ResetMatrices();
-			
-			modelTranslate = glm::translate(modelTranslate, sprite->position);
-			modelScale = glm::scale(modelScale, sprite->scale);
-
-			RenderSprite(spriteShader, modelTranslate, modelScale, sprite->colour, sprite->texture);
-			sprite->Render();
-		}
+		indirectBrickRenderer->Dispatch(frustum, frame.projection[1][1]);
 	}
 
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	renderQueue.Flush();
+	frameRing->EndFrame();
 
-	spriteShader->unuse();
+	if (glfwGetTime() - lastCullingReport >= cullingReportInterval)
+	{
+		lastCullingReport = glfwGetTime();
+		ReportCulling();
+	}
 }
 
 void Game::BuildLevel()
 {
-	auto brickTexture = std::make_unique<Texture>();
-	brickTexture->Load("res\\content\\blocks\\brick_block.png");
-
-	auto grassTexture = std::make_unique<Texture>();
-	grassTexture->Load("res\\content\\blocks\\grass_block.png");
-
-	auto cobbleTexture = std::make_unique<Texture>();
-	cobbleTexture->Load("res\\content\\blocks\\cobble_block.png");
-
-	auto ironTexture = std::make_unique<Texture>();
-	ironTexture->Load("res\\content\\blocks\\iron_block.png");
-
-	auto goldTexture = std::make_unique<Texture>();
-	goldTexture->Load("res\\content\\blocks\\gold_block.png");
-
-	auto emeraldTexture = std::make_unique<Texture>();
-	emeraldTexture->Load("res\\content\\blocks\\emerald_block.png");
-
-	auto diamondTexture = std::make_unique<Texture>();
-	diamondTexture->Load("res\\content\\blocks\\diamond_block.png");
-
-	auto crackedTexture = std::make_unique<Texture>();
-	crackedTexture->Load("res\\content\\crack.png");
-	
-	for (int y = 0; y < numbBricksHigh; y++)
-	{
-		for (int x = 0; x < numbBricksWide; x++)
-		{
-			_brick = std::make_unique<Brick>();
-			_brick->loadASSIMP("res\\mesh\\cube.obj");
-			_brick->setBuffers();
-
-			_brick->scale = glm::vec3(0.5f, 0.5f, 0.5f);
-			_brick->position = (glm::vec3(-9.0f + (2.0f * x), (2.0f * y), 0.0f));
-
-
-			_brick->texture = 
-				y == 0 ? *std::move(grassTexture) :
-				y == 1 ? *std::move(cobbleTexture) :
-				y == 2 ? *std::move(ironTexture) :
-				y == 3 ? *std::move(goldTexture) :
-				y == 4 ? *std::move(diamondTexture) :
-				*std::move(emeraldTexture);
-
-			_brick->cracked = *std::move(crackedTexture);
-
-			bricks[y][x] = std::move(_brick);
-
-		}
-	}
+	walls.Clear();
+	walls.Reserve(boundBlocks * 2 + topBlocks);
 
 	for (int i = 0; i < boundBlocks; i++)
 	{
-		_brickLeft = std::make_unique<Brick>();
-		_brickLeft->loadASSIMP("res\\mesh\\cube.obj");
-		_brickLeft->setBuffers();
-
-		_brickLeft->scale = glm::vec3(0.5f, 0.5f, 0.5f);
-		_brickLeft->position = (glm::vec3(-12.0f, -10.0f + i, 0.0f));
-
-		_brickLeft->texture = *std::move(brickTexture);
-
-		boundLeft[i] = std::move(_brickLeft);
+		walls.Add(glm::vec3(-12.0f, -10.0f + i, 0.0f), glm::vec3(0.5f, 0.5f, 0.5f), BrickBlock);
 	}
 
 	for (int i = 0; i < topBlocks; i++)
 	{
-		_brickTop = std::make_unique<Brick>();
-		_brickTop->loadASSIMP("res\\mesh\\cube.obj");
-		_brickTop->setBuffers();
-
-		_brickTop->scale = glm::vec3(0.5f, 0.5f, 0.5f);
-		_brickTop->position = (glm::vec3(-12.0f + i, 10.0f, 0.0f));
-
-		_brickTop->texture = *std::move(brickTexture);
-
-		boundTop[i] = std::move(_brickTop);
+		walls.Add(glm::vec3(-12.0f + i, 10.0f, 0.0f), glm::vec3(0.5f, 0.5f, 0.5f), BrickBlock);
 	}
 	
 	for (int i = 0; i < boundBlocks; i++)
 	{
-		_brickRight = std::make_unique<Brick>();
-		_brickRight->loadASSIMP("res\\mesh\\cube.obj");
-		_brickRight->setBuffers();
-
-		_brickRight->scale = glm::vec3(0.5f, 0.5f, 0.5f);
-		_brickRight->position = (glm::vec3(12.0f, -10.0f + i, 0.0f));
-
-		_brickRight->texture = *std::move(brickTexture);
-
-		boundRight[i] = std::move(_brickRight);
+		walls.Add(glm::vec3(12.0f, -10.0f + i, 0.0f), glm::vec3(0.5f, 0.5f, 0.5f), BrickBlock);
 	}
 }
 
-void Game::UpdateCameraView()
-{
-	updateView = false;
-}
-
-bool Game::IsGameFinished()
+void Game::BuildHud()
 {
-	for (int y = 0; y < numbBricksHigh; y++)
-	{
-		for (int x = 0; x < numbBricksWide; x++)
-		{
-			if (bricks[y][x]->brickAlive)
-			{
-				return !bricks[y][x]->brickAlive;
-			}
-		}
-	}
+	spriteBatch->Begin();
 
-	return true;
-}
-
-void Game::UpdatePlayerPosition()
-{
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	for (int i = 0; i < builtHud.lives; i++)
 	{
-		state = GameState::Exit;
-		glfwSetWindowShouldClose(window, true);
-	}
+		const glm::vec2 position(lives->position.x + (i * 40.0f), lives->position.y);
 
-	if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS)
-	{
-		stuckToPaddle = false;
+		spriteBatch->Submit(*lives->texture, position, glm::vec2(lives->scale), lives->colour);
 	}
 
-	if (player->lives > 0)
+	for (const Sprite* overlay : { win.get(), gameover.get() })
 	{
-
-		if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
+		if (overlay->active)
 		{
-			if (player->position.x > -11.25f + offset)
-			{
-				player->position.x -= player->velocity.x * deltaTime;
-			}
-		}
-		
-		if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
-		{
-			if (player->position.x < 11.15f - offset)
-			{
-				player->position.x += player->velocity.x * deltaTime;
-			}
+			spriteBatch->Submit(*overlay->texture, glm::vec2(overlay->position), glm::vec2(overlay->scale), overlay->colour);
 		}
+	}
 
-		if (stuckToPaddle)
-		{
-			ball->position = glm::vec3
-			(
-				player->position.x,
-				player->position.y + player->scale.y + (ball->scale.y * 2),
-				player->position.z
-			);
-		}
+	spriteBatch->Submit(*scoreTitle->texture, glm::vec2(scoreTitle->position), glm::vec2(scoreTitle->scale), scoreTitle->colour);
+	scoreLabel->Submit(*spriteBatch);
 
-		glDrawArrays(GL_TRIANGLES, 0, 36);
-	}
-	else if (player->lives <= 0)
-	{
-		state = GameState::Lose;
-	}
+	spriteBatch->End();
 }
 
-void Game::UpdateBallPosition()
+void Game::ReportCulling()
 {
-	if (!stuckToPaddle)
-	{
-		ball->position.x += ball->velocity.x * deltaTime;
-		
-		if (ball->position.x <= -11.0f)
-		{
-			ball->velocity.x = -ball->velocity.x;
-			ball->position.x = -11.0f;
-		}
-		else if (ball->position.x >= 11.0f)
-		{
-			ball->velocity.x = -ball->velocity.x;
-			ball->position.x = 11.0f;
-		}
-
-		for (int y = 0; y < numbBricksHigh; y++)
-		{
-			for (int x = 0; x < numbBricksWide; x++)
-			{
-				if (bricks[y][x]->brickAlive)
-				{
-					if (CollisionDetection(ball, bricks[y][x]))
-					{
-						SetCrackedBrick(x, y);
-						
-						ball->velocity.x = -ball->velocity.x;
-						ball->position.x += ball->velocity.x * deltaTime;
-					}
-					
-					if (bricks[y][x]->hits < 0)
-					{
-						SetDeadBrick(x, y);
-					}
-				}
-				
-				if (bricks[y][x]->brickDying)
-				{
-					SetDyingBrick(x, y);
-				}
-
-				if (bricks[y][x]->position.y < -15.0f)
-				{
-					bricks[y][x]->brickDying = false;
-				}
-			}
-		}
+	unsigned visible = GetVisibleObjects();
+	unsigned culled = GetCulledObjects();
 
-		ball->position.y += ball->velocity.y * deltaTime;
-
-		if (ball->position.y >= 9.0f)
-		{
-			ball->velocity.y = -ball->velocity.y;
-			ball->position.y = 9.0f;
-		}
-		else if (ball->position.y <= -15.0f)
-		{
-			player->lives--;
-			stuckToPaddle = true;
-		}
-		else if (CollisionDetection(ball, player))
-		{
-			ball->velocity.y = abs(ball->velocity.y);
-		}
-
-		for (int y = 0; y < numbBricksHigh; y++)
-		{
-			for (int x = 0; x < numbBricksWide; x++)
-			{
-				if (bricks[y][x]->brickAlive)
-				{
-					if (CollisionDetection(ball, bricks[y][x]))
-					{
-						SetCrackedBrick(x, y);
-						
-						ball->velocity.y = -ball->velocity.y;
-						ball->position.y += ball->velocity.y * deltaTime;
-					}
-					
-					if (bricks[y][x]->hits < 0)
-					{
-						SetDeadBrick(x, y);
-					}
-				}
-				
-				if (bricks[y][x]->brickDying)
-				{
-					SetDyingBrick(x, y);
-				}
-
-				if (bricks[y][x]->position.y < -15.0f)
-				{
-					bricks[y][x]->brickDying = false;
-				}
-			}
-		}
+	if (indirectBrickRenderer)
+	{
+		unsigned visibleBricks = 0;
+		unsigned culledBricks = 0;
+		indirectBrickRenderer->ReadCounts(visibleBricks, culledBricks);
 
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+		visible += visibleBricks;
+		culled += culledBricks;
 	}
-}
 
-bool Game::CollisionDetection(std::unique_ptr<Ball>& ball, std::unique_ptr<Brick>& brick)
-{
-	float ballLeft = ball->position.x - ball->scale.x;
-	float ballRight = ball->position.x + ball->scale.x;
-	float ballTop = ball->position.y - ball->scale.x;
-	float ballBottom = ball->position.y + ball->scale.x;
-
-	float brickLeft = brick->position.x - brick->scale.x;
-	float brickRight = brick->position.x + brick->scale.x;
-	float brickTop = brick->position.y - brick->scale.x;
-	float brickBottom = brick->position.y + brick->scale.x;
-
-	if (ballBottom <= brickTop) return false;
-	if (ballTop >= brickBottom) return false;
-	if (ballRight <= brickLeft) return false;
-	if (ballLeft >= brickRight) return false;
-
-	return true;
-}
+	std::cout << "Culling: " << visible << " objects visible, " << culled << " culled" << std::endl;
 
-bool Game::CollisionDetection(std::unique_ptr<Ball>& ball, std::unique_ptr<Player>& player)
-{
-	float ballLeft = ball->position.x - ball->scale.x;
-	float ballRight = ball->position.x + ball->scale.x;
-	float ballTop = ball->position.y - ball->scale.x;
-	float ballBottom = ball->position.y + ball->scale.x;
-
-	float playerLeft = player->position.x - player->scale.x;
-	float playerRight = player->position.x + player->scale.x;
-	float playerTop = player->position.y - player->scale.y;
-	float playerBottom = player->position.y + player->scale.y;
-
-	if (ballBottom <= playerTop) return false;
-	if (ballTop >= playerBottom) return false;
-	if (ballRight <= playerLeft) return false;
-	if (ballLeft >= playerRight) return false;
-
-	return true;
-}
+	// Render resets the counters at the start of each frame, so these are the frame just drawn
+	std::cout << "State changes: " << GLStateCache::GetIssued() << " issued, " << GLStateCache::GetElided() << " elided" << std::endl;
 
-void Game::SetCrackedBrick(const int x, const int y)
-{
-	bricks[y][x]->hits -= 1;
-	bricks[y][x]->texture =  bricks[y][x]->cracked;
-	
-	score += 1;
-	SetScore();
+	// the queue keeps the frame's items until the next Begin
+	std::cout << "Render queue: " << renderQueue.GetDrawCount() << " draws, " << renderQueue.GetStateChanges() << " state changes after sorting" << std::endl;
 }
 
-void Game::SetDeadBrick(const int x, const int y)
+void Game::UpdateCameraView()
 {
-	bricks[y][x]->brickDying = true;
-	bricks[y][x]->brickAlive = false;
-	
-	score += 3;
-	SetScore();
+	updateView = false;
 }
 
-void Game::SetDyingBrick(const int x, const int y)
+void Game::SubmitObject(const Model& object, const glm::mat4& model, const glm::vec3& colour, const Texture& texture, const Frustum& frustum)
 {
-	bricks[y][x]->position.y -= 9.5f * deltaTime;
-	bricks[y][x]->rotation += 0.075f;
-	
-	if (bricks[y][x]->scale.x > 0.0f)
+	const MeshBounds& bounds = object.mesh->GetBounds();
+	const glm::vec4 sphere = TransformSphere(model, bounds.centre, bounds.radius);
+
+	if (!frustum.IntersectsSphere(glm::vec3(sphere), sphere.w))
 	{
-		bricks[y][x]->scale -= 0.75f * deltaTime;
+		culledObjects++;
+		return;
 	}
-}
 
-void Game::RenderSprite(std::unique_ptr<Shader>& shader, glm::mat4 translation, glm::mat4 scale, glm::vec3 colour, Texture& texture)
-{
-	shader->setFloatMat4("uModel", glm::mat4(translation * scale));
-	shader->setFloatMat4("uView", glm::mat4(orthoViewMatrix));
-	shader->setFloatMat4("uProjection", glm::mat4(orthoProgMatrix));
-	shader->setFloat3("uColour", glm::vec3(colour.x, colour.y, colour.z));
+	visibleObjects++;
 
-	glBindTexture(GL_TEXTURE_2D, texture.GetTexture());
-}
+	const IndexBuffer& ibo = *object.mesh->GetVAO()->GetIBO();
 
-void Game::RenderObject(std::unique_ptr<Shader>& shader, glm::mat4 translation, glm::mat4 rotation, glm::mat4 scale, glm::vec3 colour, Texture& texture)
-{
-	shader->setFloat3("uObjectColour", glm::vec3(colour.x, colour.y, colour.z));
-	shader->setFloat3("uLightColour", glm::vec3(_lightColour.x, _lightColour.y, _lightColour.z));
-	shader->setFloat3("uLightPosition", glm::vec3(_lightPos.x, _lightPos.y, _lightPos.z));
-	shader->setFloat3("uViewPosition", glm::vec3(camera->Position.x, camera->Position.y, camera->Position.z));
+	// the scale is uniform when the columns are orthogonal and of equal length, transpose(m) * m == s^2 * I.
+	// Equal lengths alone are not enough, a non-uniform scale applied after a rotation keeps them equal at some angles
+	const glm::mat3 linear(model);
+	const glm::mat3 gram = glm::transpose(linear) * linear;
+	const float squaredScale = gram[0][0];
 
-	shader->setFloatMat4("uModel", glm::mat4(translation * rotation * scale));
-	shader->setFloatMat4("uView", glm::mat4(camera->GetViewMatrix()));
-	shader->setFloatMat4("uProjection", glm::mat4(glm::perspective(glm::radians(90.0f), (float)screenWidth / (float)screenHeight, 0.1f, 1000.0f)));
+	bool uniformScale = true;
 
-	glBindTexture(GL_TEXTURE_2D, texture.GetTexture());
+	for (int column = 0; column < 3; column++)
+	{
+		for (int row = 0; row < 3; row++)
+		{
+			const float expected = column == row ? squaredScale : 0.0f;
+			uniformScale = uniformScale && glm::abs(gram[column][row] - expected) <= 1e-4f * squaredScale;
+		}
+	}
+
+	// view, projection and lighting come from the FrameData uniform buffer
+	DrawItem item;
+	item.shader = uniformScale ? uniformScaleShader.get() : shader.get();
+	item.vao = object.mesh->GetVAO();
+	item.textureTarget = GL_TEXTURE_2D;
+	item.texture = texture.GetTexture();
+	item.count = object.mesh->GetLods()[0].count;
+	item.indexType = ibo.GetType();
+	item.objectUniforms = true;
+	item.model = model;
+	item.colour = colour;
+
+	// only a non-uniform scale needs the inverse transpose, done here once instead of per vertex
+	if (!uniformScale)
+	{
+		item.normalMatrix = glm::inverseTranspose(glm::mat3(model));
+	}
+
+	renderQueue.Submit(item, OpaquePass, glm::distance(camera->Position, glm::vec3(model[3])) / farPlane);
 }
 
 void Game::ResetMatrices()
@@ -782,62 +565,50 @@ void Game::ResetMatrices()
 
 void Game::LoadScore()
 {
-	const glm::vec3 scale = glm::vec3(40.0f, 40.0f, 1.0f);
+	scoreTitle = std::make_unique<Sprite>();
+	scoreTitle->scale = glm::vec3(160.0f, 50.0f, 1.0f);
+	scoreTitle->position = glm::vec3
+	(
+		(GLfloat)screenWidth - 280.0f,
+		(GLfloat)screenHeight - scoreTitle->scale.y - (-15.0f),
+		0.0f
+	);
 
-	for (int i = 0; i < 4; i++)
-	{
-		auto sprite = std::make_unique<Sprite>();
-		sprite->SetBuffers();
+	scoreTitle->texture = textureCache->Load("res\\content\\score_text.png");
 
-		if (i == 0)
-		{
-			sprite->scale = glm::vec3(160.0f, 50.0f, 1.0f);
-			sprite->position = glm::vec3
-			(
-				(GLfloat)screenWidth - 280.0f,
-				(GLfloat)screenHeight - sprite->scale.y - (-15.0f),
-				0.0f
-			);
-			
-			sprite->texture.Load("res\\content\\score_text.png");
-		}
-		else
-		{
-			sprite->scale = scale;
-			sprite->position = glm::vec3
-			(
-				(GLfloat)screenWidth - 140.0f + (i * 30.0f),
-				(GLfloat)screenHeight - sprite->scale.y - (-5.0f),
-				0.0f
-			);
-			
-			sprite->texture.Load("res\\content\\0.png");
-		}
-		
-		scoreObject.push_back(std::move(sprite));
-	}
+	std::vector<std::pair<char, std::string>> digits;
 
-	for (int i = 0; i < 10; i++)
+	for (char digit = '0'; digit <= '9'; digit++)
 	{
-		auto texture = std::make_unique<Texture>();
-		auto file = "res\\content\\" + std::to_string(i) + ".png";
-		
-		texture->Load(file);
-		
-		scoreText.push_back(std::move(texture));
+		digits.push_back({ digit, "res\\content\\" + std::string(1, digit) + ".png" });
 	}
+
+	glyphs = std::make_unique<GlyphAtlas>();
+	glyphs->Load(digits);
+
+	// right aligned where the last of the old three digit slots ended, glyphs overlap like the slots did
+	const float digitHeight = 40.0f;
+
+	scoreLabel = std::make_unique<TextLabel>
+	(
+		*glyphs,
+		glm::vec2((GLfloat)screenWidth - 10.0f, (GLfloat)screenHeight - digitHeight - (-5.0f)),
+		digitHeight,
+		TextAlign::Right
+	);
+
+	scoreLabel->spacing = -10.0f;
+
+	SetScore();
 }
 
 void Game::SetScore()
 {
-	std::string scoreStr = std::to_string(score);
+	displayedScore = snapshot->score;
 
-	int pos = static_cast<int>(scoreObject.size()) - 1;
+	// at least three digits, longer scores simply grow to the left
+	std::string text = std::to_string(displayedScore);
+	text.insert(0, text.length() < scoreDigits ? scoreDigits - text.length() : 0, '0');
 
-	for (int i = (int)scoreStr.length() - 1; i >= 0; i--)
-	{
-		int value = scoreStr[i] - '0';
-		scoreObject[pos]->texture = std::move(*scoreText[value]);
-		pos--;
-	}
+	scoreLabel->SetText(text);
 }
\ No newline at end of file
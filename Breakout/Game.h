@@ -4,17 +4,26 @@
 
 
 #include "Shader.h"
+#include "TextureCache.h"
 #include "VertexArray.h"
+#include "buffers/DynamicRingBuffer.h"
 
 #include "Camera.h"
-#include "models/Ball.h"
-#include "models/Brick.h"
 #include "models/Model.h"
 #include "models/Player.h"
 #include "models/Sprite.h"
 #include "models/GameObject.h"
-
-enum class GameState { Play, Win, Lose, Exit };
+#include "models/MeshCache.h"
+#include "renderers/BallRenderer.h"
+#include "renderers/BrickRenderer.h"
+#include "renderers/FrameData.h"
+#include "renderers/Frustum.h"
+#include "renderers/IndirectBrickRenderer.h"
+#include "renderers/RenderQueue.h"
+#include "renderers/SpriteBatch.h"
+#include "renderers/TextLabel.h"
+#include "simulation/BrickField.h"
+#include "simulation/SimulationThread.h"
 
 struct GLFWwindow;
 
@@ -24,57 +33,96 @@ public:
 	Game();
 	void Run();
 
+	// objects drawn and culled on the CPU by the last frame. Bricks culled on the GPU by the indirect renderer
+	// are only counted by the periodic culling report, which reads them back
+	unsigned GetVisibleObjects() const { return visibleObjects; }
+	unsigned GetCulledObjects() const { return culledObjects; }
+
 private:
 	void Init();
-	void Update(float dt);
+	void Shutdown();
+	void Update();
 	void Render();
 
 	void BuildLevel();
 	void UpdateCameraView();
-	bool IsGameFinished();
-	
-	void UpdatePlayerPosition();
-	void UpdateBallPosition();
-	
-	bool CollisionDetection(std::unique_ptr<Ball>& ball, std::unique_ptr<Brick>& brick);
-	bool CollisionDetection(std::unique_ptr<Ball>& ball, std::unique_ptr<Player>& player);
-
-	void SetCrackedBrick(int x, int y);
-	void SetDeadBrick(int x, int y);
-	void SetDyingBrick(int x, int y);
 
 	void LoadScore();
 	void SetScore();
 
-	void RenderObject(std::unique_ptr<Shader>& shader, glm::mat4 translation, glm::mat4 rotation, glm::mat4 scale, glm::vec3 colour, Texture& texture);
-	void RenderSprite(std::unique_ptr<Shader>& shader, glm::mat4 translation, glm::mat4 scale, glm::vec3 colour, Texture& texture);
+	void BuildHud();
+
+	// logs the last frame's visible and culled objects, including the bricks culled on the GPU, the GL state
+	// changes it issued and dropped, and the render queue's draws and state changes
+	void ReportCulling();
+
+	// queues a single mesh drawn with the projection shader unless it is outside the frustum
+	void SubmitObject(const Model& object, const glm::mat4& model, const glm::vec3& colour, const Texture& texture, const Frustum& frustum);
 	void ResetMatrices();
 	
 	std::string resDir;
 
-	bool finishGame;
-
-	GameState state;
+	// game rules run in fixed steps on their own thread, each frame draws the latest snapshot they published
+	std::unique_ptr<SimulationThread> simulation;
+	const RenderSnapshot* snapshot = nullptr;
+	int displayedScore;
 
 	std::unique_ptr<Camera> camera;
 	std::unique_ptr<Shader> shader;
+	// the projection shader without the normal matrix, for objects scaled the same along every axis
+	std::unique_ptr<Shader> uniformScaleShader;
 	std::unique_ptr<Shader> spriteShader;
 
+	// per frame data: the frame uniforms and the instances, written straight into mapped memory
+	std::unique_ptr<DynamicRingBuffer> frameRing;
+
+	std::unique_ptr<MeshCache> meshCache;
+	// decodes the cache's images in the background and uploads a few each frame
+	std::unique_ptr<TextureLoader> textureLoader;
+	std::unique_ptr<TextureCache> textureCache;
+	// only one of the two exists, the indirect one when compute shaders are available
+	std::unique_ptr<BrickRenderer> brickRenderer;
+	std::unique_ptr<IndirectBrickRenderer> indirectBrickRenderer;
+	std::unique_ptr<BallRenderer> ballRenderer;
+	std::unique_ptr<SpriteBatch> spriteBatch;
+
+	RenderQueue renderQueue;
+
+	// objects drawn and culled by the last frame
+	unsigned visibleObjects = 0;
+	unsigned culledObjects = 0;
+	double lastCullingReport = 0.0;
+
+	// what the HUD batch was last built from, it is only rebuilt when this changes
+	struct HudState
+	{
+		int lives = -1;
+		int score = -1;
+		bool win = false;
+		bool gameover = false;
+
+		bool operator==(const HudState&) const = default;
+	};
+
+	HudState builtHud;
+
 	std::unique_ptr<GameObject> background;
 	std::unique_ptr<Player> player;
 	std::unique_ptr<Sprite> lives;
+	std::unique_ptr<Sprite> scoreTitle;
+	std::unique_ptr<GlyphAtlas> glyphs;
+	std::unique_ptr<TextLabel> scoreLabel;
 	std::unique_ptr<Sprite> win;
 	std::unique_ptr<Sprite> gameover;
-	std::unique_ptr<Ball> ball;
 	
-	std::unique_ptr<Brick> _brick;
-	std::unique_ptr<Brick> _brickLeft;
-	std::unique_ptr<Brick> _brickRight;
-	std::unique_ptr<Brick> _brickTop;
+	// the bricks themselves are owned by the simulation
+	BrickField walls;
 
 	GLFWwindow* window;
 
 	glm::vec3 _lightPos = glm::vec3(30.0f, 30.0f, 30.0f);
 	const glm::vec3 _lightColour = glm::vec3(0.8f, 0.9f, 0.8f);
+	const glm::vec3 _ballColour = glm::vec3(1.0f, 1.0f, 1.0f);
+	const glm::vec3 _powerUpColour = glm::vec3(1.0f, 0.85f, 0.3f);
 	const GLfloat _lightRotation = -0.001f;
 };
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "ProgramCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include <glad/glad.h>
+
+namespace
+{
+	// "BKPB", bumped with the version whenever the file layout changes
+	const uint32_t binaryMagic = 0x42504B42;
+	const uint32_t binaryVersion = 1;
+
+	struct BinaryHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t key;
+		uint32_t format;
+		uint32_t length;
+	};
+
+	std::string directory = "shadercache";
+
+	ProgramCache::Stats stats;
+
+	// FNV-1a, 64 bit
+	uint64_t Hash(uint64_t hash, const void* data, size_t size)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	uint64_t HashString(uint64_t hash, const char* text)
+	{
+		// the terminator keeps "ab" + "c" apart from "a" + "bc"
+		return text ? Hash(hash, text, strlen(text) + 1) : Hash(hash, "", 1);
+	}
+
+	std::filesystem::path PathOf(uint64_t key)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+
+		return std::filesystem::path(directory) / name;
+	}
+
+	// drivers without a binary format cannot use the cache at all
+	bool Supported()
+	{
+		GLint formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+		return formats > 0;
+	}
+}
+
+void ProgramCache::SetDirectory(const std::string& path)
+{
+	directory = path;
+}
+
+uint64_t ProgramCache::MakeKey(const std::vector<std::pair<unsigned, std::string>>& stages)
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+
+	hash = HashString(hash, (const char*)glGetString(GL_VENDOR));
+	hash = HashString(hash, (const char*)glGetString(GL_RENDERER));
+	hash = HashString(hash, (const char*)glGetString(GL_VERSION));
+
+	for (const auto& stage : stages)
+	{
+		hash = Hash(hash, &stage.first, sizeof(stage.first));
+		hash = HashString(hash, stage.second.c_str());
+	}
+
+	return hash;
+}
+
+unsigned ProgramCache::Load(uint64_t key)
+{
+	if (!Supported())
+	{
+		return 0;
+	}
+
+	std::ifstream file(PathOf(key), std::ios::binary);
+
+	if (!file)
+	{
+		return 0;
+	}
+
+	BinaryHeader header = {};
+	file.read((char*)&header, sizeof(header));
+
+	if (!file || header.magic != binaryMagic || header.version != binaryVersion || header.key != key)
+	{
+		return 0;
+	}
+
+	// a truncated or corrupted entry must not turn its length into a huge allocation
+	const std::streamoff headerEnd = file.tellg();
+	file.seekg(0, std::ios::end);
+	const std::streamoff remaining = file.tellg() - headerEnd;
+	file.seekg(headerEnd);
+
+	if (header.length == 0 || (std::streamoff)header.length > remaining)
+	{
+		return 0;
+	}
+
+	std::vector<char> binary(header.length);
+	file.read(binary.data(), binary.size());
+
+	if (!file)
+	{
+		return 0;
+	}
+
+	const unsigned program = glCreateProgram();
+	glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+
+	// a driver may still refuse a binary from an older build of itself, the caller then compiles
+	GLint success = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+	if (!success)
+	{
+		std::cout << "ProgramCache: stored binary " << PathOf(key).string() << " was rejected, compiling" << std::endl;
+		glDeleteProgram(program);
+
+		return 0;
+	}
+
+	return program;
+}
+
+void ProgramCache::Store(uint64_t key, unsigned program)
+{
+	if (!Supported())
+	{
+		return;
+	}
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+	if (length <= 0)
+	{
+		return;
+	}
+
+	std::vector<char> binary(length);
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &length, &format, binary.data());
+
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+
+	// written under a temporary name first so a crash never leaves a truncated entry behind
+	const std::filesystem::path path = PathOf(key);
+	std::filesystem::path temporary = path;
+	temporary += ".tmp";
+
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+
+		if (!file)
+		{
+			std::cout << "ProgramCache: cannot write " << temporary.string() << std::endl;
+			return;
+		}
+
+		const BinaryHeader header = { binaryMagic, binaryVersion, key, format, (uint32_t)length };
+
+		file.write((const char*)&header, sizeof(header));
+		file.write(binary.data(), length);
+
+		// closing flushes the last of the data, which can fail as well, on a full disk for example
+		file.close();
+
+		if (!file)
+		{
+			std::cout << "ProgramCache: writing " << temporary.string() << " failed" << std::endl;
+			std::filesystem::remove(temporary, error);
+			return;
+		}
+	}
+
+	std::filesystem::rename(temporary, path, error);
+}
+
+void ProgramCache::Record(bool loaded, double seconds)
+{
+	if (loaded)
+	{
+		stats.loaded++;
+		stats.loadSeconds += seconds;
+	}
+	else
+	{
+		stats.compiled++;
+		stats.compileSeconds += seconds;
+	}
+}
+
+const ProgramCache::Stats& ProgramCache::GetStats()
+{
+	return stats;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Keeps linked program binaries on disk so later launches skip compiling their shaders.
+// An entry is keyed by a hash of every stage's type and source, defines included, and of the GL vendor,
+// renderer and version strings, so an edited shader or a driver update simply misses and is compiled again.
+class ProgramCache
+{
+public:
+	// seconds spent building programs since startup, split by how they were built
+	struct Stats
+	{
+		unsigned loaded = 0;
+		unsigned compiled = 0;
+		double loadSeconds = 0.0;
+		double compileSeconds = 0.0;
+	};
+
+	// where the binaries are kept, created by the first Store
+	static void SetDirectory(const std::string& directory);
+
+	static uint64_t MakeKey(const std::vector<std::pair<unsigned, std::string>>& stages);
+
+	// creates a program from the stored binary, 0 when there is none or the driver rejects it
+	static unsigned Load(uint64_t key);
+
+	// writes the binary of a linked program, linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+	static void Store(uint64_t key, unsigned program);
+
+	static void Record(bool loaded, double seconds);
+	static const Stats& GetStats();
+};
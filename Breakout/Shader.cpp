@@ -1,8 +1,12 @@
 #include "Shader.h"
+#include "GLStateCache.h"
+#include "ProgramCache.h"
+
+#include <chrono>
 
 #include <glm/gtc/type_ptr.hpp>
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath)
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const std::vector<std::string>& defines)
 {
     std::string vertexCode;
     std::string fragmentCode;
@@ -29,53 +33,95 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
         fShaderFile.close();
     	
         // convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+        vertexCode = injectDefines(vShaderStream.str(), defines);
+        fragmentCode = injectDefines(fShaderStream.str(), defines);
     }
     catch (std::ifstream::failure e)
     {
         std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
     }
 
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
+    build({ { GL_VERTEX_SHADER, vertexCode }, { GL_FRAGMENT_SHADER, fragmentCode } });
+}
 
-    const auto vertexShader = glCreateShader(GL_VERTEX_SHADER);
+Shader::Shader(const char* computePath, const std::vector<std::string>& defines)
+{
+    std::string computeCode;
+    std::ifstream cShaderFile;
 
-    glShaderSource(vertexShader, 1, &vShaderCode, nullptr);
+    cShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
 
-    glCompileShader(vertexShader);
+    try
+    {
+        cShaderFile.open(computePath);
+        std::stringstream cShaderStream;
 
-    int  success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+        cShaderStream << cShaderFile.rdbuf();
+        cShaderFile.close();
 
-    if (!success)
+        computeCode = injectDefines(cShaderStream.str(), defines);
+    }
+    catch (const std::ifstream::failure&)
     {
-        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
     }
 
-    const auto fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    build({ { GL_COMPUTE_SHADER, computeCode } });
+}
 
-    glShaderSource(fragmentShader, 1, &fShaderCode, nullptr);
+void Shader::build(const std::vector<std::pair<GLenum, std::string>>& stages)
+{
+    const auto start = std::chrono::steady_clock::now();
 
-    glCompileShader(fragmentShader);
+    const uint64_t key = ProgramCache::MakeKey(stages);
 
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+    ID = ProgramCache::Load(key);
 
-    if (!success)
+    if (ID != 0)
     {
-        glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+        ProgramCache::Record(true, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        reflectUniforms();
+        return;
     }
 
     ID = glCreateProgram();
 
-    glAttachShader(ID, vertexShader);
-    glAttachShader(ID, fragmentShader);
+    std::vector<unsigned> shaders;
+
+    for (const auto& stage : stages)
+    {
+        const char* code = stage.second.c_str();
+        const auto shader = glCreateShader(stage.first);
+
+        glShaderSource(shader, 1, &code, nullptr);
+
+        glCompileShader(shader);
+
+        int  success;
+        char infoLog[512];
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+
+        if (!success)
+        {
+            const char* name = stage.first == GL_VERTEX_SHADER ? "VERTEX"
+                : stage.first == GL_FRAGMENT_SHADER ? "FRAGMENT"
+                : "COMPUTE";
+
+            glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+            std::cout << "ERROR::SHADER::" << name << "::COMPILATION_FAILED\n" << infoLog << std::endl;
+        }
+
+        glAttachShader(ID, shader);
+        shaders.push_back(shader);
+    }
+
+    // has to be set before linking for glGetProgramBinary to return anything
+    glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(ID);
 
+    int  success;
+    char infoLog[512];
     glGetProgramiv(ID, GL_LINK_STATUS, &success);
 
     if (!success)
@@ -84,43 +130,143 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
         std::cout << "ERROR::SHADER::LINK_FAILED\n" << infoLog << std::endl;
     }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    for (const auto shader : shaders)
+    {
+        glDeleteShader(shader);
+    }
+
+    if (success)
+    {
+        ProgramCache::Store(key, ID);
+    }
+
+    ProgramCache::Record(false, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+    reflectUniforms();
+}
+
+void Shader::reflectUniforms()
+{
+    int count = 0;
+    int maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::string name(maxLength, '\0');
+
+    for (int i = 0; i < count; i++)
+    {
+        int length = 0;
+        int size = 0;
+        GLenum type;
+        glGetActiveUniform(ID, i, maxLength, &length, &size, &type, &name[0]);
+
+        const std::string uniform = name.substr(0, length);
+        const int location = glGetUniformLocation(ID, uniform.c_str());
+
+        // members of uniform blocks have no location
+        if (location < 0)
+        {
+            continue;
+        }
+
+        _uniforms[uniform] = location;
+
+        // arrays are reported as "name[0]", allow them to be set by their plain name as well
+        const auto bracket = uniform.find('[');
+
+        if (bracket != std::string::npos)
+        {
+            _uniforms[uniform.substr(0, bracket)] = location;
+        }
+    }
+}
+
+std::string Shader::injectDefines(const std::string& code, const std::vector<std::string>& defines)
+{
+    if (defines.empty())
+    {
+        return code;
+    }
+
+    std::string lines;
+
+    for (const auto& define : defines)
+    {
+        lines += "#define " + define + "\n";
+    }
+
+    const auto versionEnd = code.find('\n');
+
+    if (versionEnd == std::string::npos)
+    {
+        return code + "\n" + lines;
+    }
+
+    return code.substr(0, versionEnd + 1) + lines + code.substr(versionEnd + 1);
+}
+
+int Shader::getLocation(const std::string& name) const
+{
+    const auto uniform = _uniforms.find(name);
+
+    return uniform != _uniforms.end() ? uniform->second : -1;
 }
 
 void Shader::use()
 {
-    glUseProgram(ID);
+    GLStateCache::UseProgram(ID);
 }
 
 void Shader::unuse()
 {
-    glUseProgram(0);
+    GLStateCache::UseProgram(0);
 }
 
 void Shader::setBool(const std::string& name, bool value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    glUniform1i(getLocation(name), (int)value);
 }
 
 void Shader::setInt(const std::string& name, int value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(getLocation(name), value);
+}
+
+void Shader::setUint(const std::string& name, unsigned value) const
+{
+    glUniform1ui(getLocation(name), value);
 }
 
 void Shader::setFloat(const std::string& name, float value) const
 {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(getLocation(name), value);
 }
 
 void Shader::setFloat3(const std::string& name, glm::vec3 value) const
 {
-    const auto transformLoc = glGetUniformLocation(ID, name.c_str());
+    const auto transformLoc = getLocation(name);
     glUniform3f(transformLoc, value.x, value.y, value.z);
 }
 
+void Shader::setFloatArray(const std::string& name, const float* values, int count) const
+{
+    glUniform1fv(getLocation(name), count, values);
+}
+
+void Shader::setFloat4Array(const std::string& name, const glm::vec4* values, int count) const
+{
+    glUniform4fv(getLocation(name), count, glm::value_ptr(values[0]));
+}
+
+void Shader::setFloatMat3(const std::string& name, glm::mat3 value) const
+{
+    const auto transformLoc = getLocation(name);
+    glUniformMatrix3fv(transformLoc, 1, GL_FALSE, glm::value_ptr(value));
+}
+
 void Shader::setFloatMat4(const std::string& name, glm::mat4 value) const
 {
-    const auto transformLoc = glGetUniformLocation(ID, name.c_str());
+    const auto transformLoc = getLocation(name);
     glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(value));
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <glad/glad.h>
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -15,8 +17,11 @@ public:
     // the program ID
     unsigned int ID;
 
-    // constructor reads and builds the shader
-    Shader(const char* vertexPath, const char* fragmentPath);
+    // constructor reads and builds the shader, each define is added to both stages as #define NAME
+    Shader(const char* vertexPath, const char* fragmentPath, const std::vector<std::string>& defines = {});
+
+    // builds a compute program from a single stage
+    explicit Shader(const char* computePath, const std::vector<std::string>& defines = {});
 
     // use/activate the shader
     void use();
@@ -24,12 +29,31 @@ public:
 	// deactivate the shader
     void unuse();
 
+    // location of an active uniform, -1 if the program does not use it
+    int getLocation(const std::string& name) const;
+
     // utility uniform functions
     void setBool(const std::string& name, bool value) const;
     void setInt(const std::string& name, int value) const;
+    void setUint(const std::string& name, unsigned value) const;
     void setFloat(const std::string& name, float value) const;
     void setFloat3(const std::string& name, glm::vec3 value) const;
+    void setFloatArray(const std::string& name, const float* values, int count) const;
+    void setFloat4Array(const std::string& name, const glm::vec4* values, int count) const;
+    void setFloatMat3(const std::string& name, glm::mat3 value) const;
     void setFloatMat4(const std::string& name, glm::mat4 value) const;
+
+private:
+    // links the stages, or loads the program from the ProgramCache when they were linked before
+    void build(const std::vector<std::pair<GLenum, std::string>>& stages);
+
+    // queries every active uniform once after linking
+    void reflectUniforms();
+
+    // defines have to follow the #version line
+    static std::string injectDefines(const std::string& code, const std::vector<std::string>& defines);
+
+    std::unordered_map<std::string, int> _uniforms;
 };
 
 #endif
\ No newline at end of file
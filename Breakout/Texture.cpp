@@ -1,16 +1,32 @@
 #include "Texture.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <glad/glad.h>
 
+#include "GLStateCache.h"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image/stb_image.h>
 
+// shown until the real image has been uploaded
+static const unsigned char placeholderPixel[4] = { 128, 128, 128, 255 };
+
+Texture::~Texture()
+{
+    if (_texture)
+    {
+        GLStateCache::ForgetTexture(_texture);
+        glDeleteTextures(1, &_texture);
+    }
+}
+
 unsigned int Texture::Load(const std::string& fileName)
 {
     // generate and bind the textures
     glGenTextures(1, &_texture);
-    glBindTexture(GL_TEXTURE_2D, _texture);
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D, _texture);
 
     // set the texture wrapping/filtering options (on the currently bound texture object)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -51,8 +67,359 @@ unsigned int Texture::Load(const std::string& fileName)
     return _texture;
 }
 
+unsigned int Texture::Create(int width, int height, const unsigned char* pixels)
+{
+    _width = width;
+    _height = height;
+
+    glGenTextures(1, &_texture);
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D, _texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _width, _height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    return _texture;
+}
+
+unsigned int Texture::CreatePlaceholder()
+{
+    glGenTextures(1, &_texture);
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D, _texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholderPixel);
+
+    return _texture;
+}
+
+void Texture::SetImage(const DecodedImage& image, const std::vector<const void*>& levelSources)
+{
+    _width = image.width;
+    _height = image.height;
+
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D, _texture);
+
+    for (int level = 0; level < (int)levelSources.size(); level++)
+    {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, std::max(1, _width >> level), std::max(1, _height >> level), 0, GL_RGBA, GL_UNSIGNED_BYTE, levelSources[level]);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (int)levelSources.size() - 1);
+
+    // the placeholder has a single level and samples it linearly
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelSources.size() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+}
+
 void Texture::Bind(unsigned textureSlot) const
 {
-    glActiveTexture(GL_TEXTURE0 + textureSlot);
-    glBindTexture(GL_TEXTURE_2D, _texture);
+    GLStateCache::BindTexture(textureSlot, GL_TEXTURE_2D, _texture);
+}
+
+// box filter an RGBA image into the destination size
+static std::vector<unsigned char> Resample(const unsigned char* src, int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+{
+    std::vector<unsigned char> dst(dstWidth * dstHeight * 4);
+
+    for (int y = 0; y < dstHeight; y++)
+    {
+        const int y0 = y * srcHeight / dstHeight;
+        const int y1 = std::max(y0 + 1, (y + 1) * srcHeight / dstHeight);
+
+        for (int x = 0; x < dstWidth; x++)
+        {
+            const int x0 = x * srcWidth / dstWidth;
+            const int x1 = std::max(x0 + 1, (x + 1) * srcWidth / dstWidth);
+
+            unsigned sum[4] = { 0, 0, 0, 0 };
+
+            for (int sy = y0; sy < y1; sy++)
+            {
+                for (int sx = x0; sx < x1; sx++)
+                {
+                    const unsigned char* pixel = src + (sy * srcWidth + sx) * 4;
+
+                    for (int c = 0; c < 4; c++)
+                    {
+                        sum[c] += pixel[c];
+                    }
+                }
+            }
+
+            const unsigned count = (x1 - x0) * (y1 - y0);
+
+            for (int c = 0; c < 4; c++)
+            {
+                dst[(y * dstWidth + x) * 4 + c] = (unsigned char)(sum[c] / count);
+            }
+        }
+    }
+
+    return dst;
+}
+
+size_t DecodedImage::GetSize() const
+{
+    size_t size = 0;
+
+    for (const auto& level : levels)
+    {
+        size += level.size();
+    }
+
+    return size;
+}
+
+DecodedImage DecodeImage(const std::vector<std::string>& fileNames)
+{
+    DecodedImage image;
+    image.layers = (int)fileNames.size();
+
+    std::vector<unsigned char> base;
+
+    for (int layer = 0; layer < image.layers; layer++)
+    {
+        int width, height, nrChannels;
+        unsigned char* data = stbi_load(fileNames[layer].c_str(), &width, &height, &nrChannels, 4);
+
+        if (!data)
+        {
+            std::cout << "Failed to load texture " << fileNames[layer] << std::endl;
+            continue;
+        }
+
+        if (image.width == 0)
+        {
+            image.width = width;
+            image.height = height;
+
+            // layers that fail to load stay transparent
+            base.resize((size_t)image.width * image.height * 4 * image.layers, 0);
+        }
+
+        const size_t layerSize = (size_t)image.width * image.height * 4;
+
+        if (width == image.width && height == image.height)
+        {
+            std::copy(data, data + layerSize, base.begin() + layer * layerSize);
+        }
+        else
+        {
+            const auto resized = Resample(data, width, height, image.width, image.height);
+            std::copy(resized.begin(), resized.end(), base.begin() + layer * layerSize);
+        }
+
+        stbi_image_free(data);
+    }
+
+    if (image.width == 0)
+    {
+        return image;
+    }
+
+    image.levels.push_back(std::move(base));
+
+    // each level halves the one before, rounding down but never below one pixel
+    for (int width = image.width, height = image.height; width > 1 || height > 1; )
+    {
+        const int nextWidth = std::max(1, width / 2);
+        const int nextHeight = std::max(1, height / 2);
+
+        const std::vector<unsigned char>& previous = image.levels.back();
+        std::vector<unsigned char> next;
+        next.reserve((size_t)nextWidth * nextHeight * 4 * image.layers);
+
+        for (int layer = 0; layer < image.layers; layer++)
+        {
+            const auto resized = Resample(previous.data() + (size_t)layer * width * height * 4, width, height, nextWidth, nextHeight);
+            next.insert(next.end(), resized.begin(), resized.end());
+        }
+
+        image.levels.push_back(std::move(next));
+
+        width = nextWidth;
+        height = nextHeight;
+    }
+
+    return image;
+}
+
+TextureArray::~TextureArray()
+{
+    if (_texture)
+    {
+        GLStateCache::ForgetTexture(_texture);
+        glDeleteTextures(1, &_texture);
+    }
+}
+
+unsigned int TextureArray::Load(const std::vector<std::string>& fileNames)
+{
+    _layers = (int)fileNames.size();
+
+    glGenTextures(1, &_texture);
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D_ARRAY, _texture);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    for (int layer = 0; layer < _layers; layer++)
+    {
+        int width, height, nrChannels;
+        unsigned char* data = stbi_load(fileNames[layer].c_str(), &width, &height, &nrChannels, 4);
+
+        if (!data)
+        {
+            std::cout << "Failed to load texture " << fileNames[layer] << std::endl;
+            continue;
+        }
+
+        if (_width == 0)
+        {
+            _width = width;
+            _height = height;
+
+            const int levels = 1 + (int)std::floor(std::log2(std::max(_width, _height)));
+            glTexStorage3D(GL_TEXTURE_2D_ARRAY, levels, GL_RGBA8, _width, _height, _layers);
+        }
+
+        if (width == _width && height == _height)
+        {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, _width, _height, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        }
+        else
+        {
+            const auto resized = Resample(data, width, height, _width, _height);
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, _width, _height, 1, GL_RGBA, GL_UNSIGNED_BYTE, resized.data());
+        }
+
+        stbi_image_free(data);
+    }
+
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+    return _texture;
+}
+
+unsigned int TextureArray::CreatePlaceholder()
+{
+    glGenTextures(1, &_texture);
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D_ARRAY, _texture);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, 1, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholderPixel);
+
+    return _texture;
+}
+
+void TextureArray::SetImage(const DecodedImage& image, const std::vector<const void*>& levelSources)
+{
+    _width = image.width;
+    _height = image.height;
+    _layers = image.layers;
+
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D_ARRAY, _texture);
+
+    for (int level = 0; level < (int)levelSources.size(); level++)
+    {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, std::max(1, _width >> level), std::max(1, _height >> level), _layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, levelSources[level]);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, (int)levelSources.size() - 1);
+}
+
+void TextureArray::Bind(unsigned textureSlot) const
+{
+    GLStateCache::BindTexture(textureSlot, GL_TEXTURE_2D_ARRAY, _texture);
+}
+
+// transparent pixels between glyphs so filtering and the smaller mips do not pick up the neighbours
+const int glyphPadding = 8;
+
+unsigned int GlyphAtlas::Load(const std::vector<std::pair<char, std::string>>& glyphFiles, int glyphHeight)
+{
+    struct LoadedGlyph
+    {
+        char character;
+        int width;
+        std::vector<unsigned char> pixels;
+    };
+
+    std::vector<LoadedGlyph> loaded;
+    int atlasWidth = glyphPadding;
+
+    for (const auto& [character, fileName] : glyphFiles)
+    {
+        int width, height, nrChannels;
+        unsigned char* data = stbi_load(fileName.c_str(), &width, &height, &nrChannels, 4);
+
+        if (!data)
+        {
+            std::cout << "Failed to load glyph " << fileName << std::endl;
+            continue;
+        }
+
+        const int glyphWidth = std::max(1, width * glyphHeight / height);
+
+        loaded.push_back({ character, glyphWidth, Resample(data, width, height, glyphWidth, glyphHeight) });
+        atlasWidth += glyphWidth + glyphPadding;
+
+        stbi_image_free(data);
+    }
+
+    // one row, glyphs copied in left to right
+    const int atlasHeight = glyphHeight + glyphPadding * 2;
+    std::vector<unsigned char> atlas(atlasWidth * atlasHeight * 4, 0);
+
+    int x = glyphPadding;
+
+    for (const auto& glyph : loaded)
+    {
+        for (int row = 0; row < glyphHeight; row++)
+        {
+            const unsigned char* src = glyph.pixels.data() + row * glyph.width * 4;
+            unsigned char* dst = atlas.data() + ((row + glyphPadding) * atlasWidth + x) * 4;
+
+            std::copy(src, src + glyph.width * 4, dst);
+        }
+
+        const unsigned index = (unsigned char)glyph.character;
+
+        if (index < _glyphs.size())
+        {
+            _glyphs[index] =
+            {
+                glm::vec2((float)x / atlasWidth, (float)glyphPadding / atlasHeight),
+                glm::vec2((float)(x + glyph.width) / atlasWidth, (float)(glyphPadding + glyphHeight) / atlasHeight),
+                (float)glyph.width / glyphHeight
+            };
+        }
+
+        x += glyph.width + glyphPadding;
+    }
+
+    return _texture.Create(atlasWidth, atlasHeight, atlas.data());
+}
+
+const Glyph* GlyphAtlas::GetGlyph(char character) const
+{
+    const unsigned index = (unsigned char)character;
+
+    return index < _glyphs.size() && _glyphs[index].aspect > 0.0f ? &_glyphs[index] : nullptr;
 }
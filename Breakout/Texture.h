@@ -1,11 +1,49 @@
 #pragma once
 
+#include <array>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include <glm/vec2.hpp>
+
+// An RGBA8 image and its whole mip chain, each level holding every layer back to back
+struct DecodedImage
+{
+	int width = 0;
+	int height = 0;
+	int layers = 0;
+
+	std::vector<std::vector<unsigned char>> levels;
+
+	size_t GetSize() const;
+};
+
+// Decodes one layer per file, resampled to the size of the first, and box filters the mips down to 1x1.
+// Touches no GL state so it can run on any thread, width is 0 when none of the files could be read
+DecodedImage DecodeImage(const std::vector<std::string>& fileNames);
+
+// GL textures are released with the object, so they are shared through TextureCache handles rather than copied
 class Texture
 {
 public:
+	Texture() = default;
+	~Texture();
+
+	Texture(const Texture&) = delete;
+	Texture& operator=(const Texture&) = delete;
+
 	unsigned int Load(const std::string& fileName);
+
+	// uploads tightly packed RGBA pixels generated at runtime
+	unsigned int Create(int width, int height, const unsigned char* pixels);
+
+	// a 1x1 grey texture whose name stays valid when SetImage replaces its contents
+	unsigned int CreatePlaceholder();
+
+	// one source per mip level, client pointers or offsets into the bound GL_PIXEL_UNPACK_BUFFER
+	void SetImage(const DecodedImage& image, const std::vector<const void*>& levelSources);
+
 	void Bind(unsigned textureSlot = 0) const;
 
 	int GetWidth() const { return _width; }
@@ -18,4 +56,64 @@ private:
 
 	int _width = 0;
 	int _height = 0;
-};
\ No newline at end of file
+};
+
+// A GL_TEXTURE_2D_ARRAY with one layer per image, so switching between them is a layer index instead of a bind
+class TextureArray
+{
+public:
+	TextureArray() = default;
+	~TextureArray();
+
+	TextureArray(const TextureArray&) = delete;
+	TextureArray& operator=(const TextureArray&) = delete;
+
+	// every image is resampled to the size of the first one
+	unsigned int Load(const std::vector<std::string>& fileNames);
+
+	// a single 1x1 grey layer, any layer index samples it until SetImage replaces it
+	unsigned int CreatePlaceholder();
+
+	// as Texture::SetImage, with every layer of a level in one source
+	void SetImage(const DecodedImage& image, const std::vector<const void*>& levelSources);
+	void Bind(unsigned textureSlot = 0) const;
+
+	int GetWidth() const { return _width; }
+	int GetHeight() const { return _height; }
+	int GetLayers() const { return _layers; }
+
+	int GetTexture() const { return _texture; }
+
+private:
+	unsigned int _texture = 0;
+
+	int _width = 0;
+	int _height = 0;
+	int _layers = 0;
+};
+
+// where a character's image sits in a GlyphAtlas, aspect is its width over its height
+struct Glyph
+{
+	glm::vec2 texCoordMin;
+	glm::vec2 texCoordMax;
+	float aspect;
+};
+
+// One texture holding an image per character packed side by side, so any string of them draws with a single bind
+class GlyphAtlas
+{
+public:
+	// every image is resampled to glyphHeight pixels keeping its aspect
+	unsigned int Load(const std::vector<std::pair<char, std::string>>& glyphFiles, int glyphHeight = 128);
+
+	// nullptr for characters the atlas has no image for
+	const Glyph* GetGlyph(char character) const;
+
+	const Texture& GetTexture() const { return _texture; }
+
+private:
+	Texture _texture;
+
+	std::array<Glyph, 128> _glyphs = {};
+};
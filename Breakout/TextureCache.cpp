@@ -0,0 +1,77 @@
+#include "TextureCache.h"
+
+std::shared_ptr<Texture> TextureCache::Load(const std::string& fileName)
+{
+	auto& entry = textures[fileName];
+
+	if (auto texture = entry.lock())
+	{
+		return texture;
+	}
+
+	auto texture = std::make_shared<Texture>();
+
+	if (loader)
+	{
+		texture->CreatePlaceholder();
+		loader->Request(texture, fileName);
+	}
+	else
+	{
+		texture->Load(fileName);
+	}
+
+	entry = texture;
+
+	return texture;
+}
+
+std::shared_ptr<TextureArray> TextureCache::LoadArray(const std::vector<std::string>& fileNames)
+{
+	std::string key;
+
+	for (const auto& fileName : fileNames)
+	{
+		key += fileName + ';';
+	}
+
+	auto& entry = arrays[key];
+
+	if (auto textureArray = entry.lock())
+	{
+		return textureArray;
+	}
+
+	auto textureArray = std::make_shared<TextureArray>();
+
+	if (loader)
+	{
+		textureArray->CreatePlaceholder();
+		loader->Request(textureArray, fileNames);
+	}
+	else
+	{
+		textureArray->Load(fileNames);
+	}
+
+	entry = textureArray;
+
+	return textureArray;
+}
+
+size_t TextureCache::GetSize() const
+{
+	size_t alive = 0;
+
+	for (const auto& [name, texture] : textures)
+	{
+		alive += !texture.expired();
+	}
+
+	for (const auto& [name, textureArray] : arrays)
+	{
+		alive += !textureArray.expired();
+	}
+
+	return alive;
+}
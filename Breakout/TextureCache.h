@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Texture.h"
+#include "TextureLoader.h"
+
+// Loads each image once and hands out reference counted handles.
+// A texture is deleted when its last handle goes away and reloaded if it is requested again.
+class TextureCache
+{
+public:
+	// with a loader, new textures start as placeholders and are filled in by it, otherwise they load on the spot
+	explicit TextureCache(TextureLoader* loader = nullptr) : loader(loader) {}
+
+	std::shared_ptr<Texture> Load(const std::string& fileName);
+
+	// the array is keyed by the whole list of files, in order
+	std::shared_ptr<TextureArray> LoadArray(const std::vector<std::string>& fileNames);
+
+	// number of textures that are still alive
+	size_t GetSize() const;
+
+private:
+	TextureLoader* loader;
+
+	std::unordered_map<std::string, std::weak_ptr<Texture>> textures;
+	std::unordered_map<std::string, std::weak_ptr<TextureArray>> arrays;
+};
@@ -0,0 +1,224 @@
+#include "TextureLoader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <glad/glad.h>
+
+#include "GLStateCache.h"
+
+TextureLoader::TextureLoader(unsigned workerCount, unsigned uploadBudget)
+	: uploadBudget(uploadBudget), staging(uploadBudget)
+{
+	if (workerCount == 0)
+	{
+		workerCount = std::max(1u, std::thread::hardware_concurrency() - 1);
+	}
+
+	for (unsigned i = 0; i < workerCount; i++)
+	{
+		workers.emplace_back(&TextureLoader::Work, this);
+	}
+}
+
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+
+	wake.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void TextureLoader::Request(const std::shared_ptr<Texture>& texture, const std::string& fileName)
+{
+	Job job;
+	job.texture = texture;
+	job.fileNames = { fileName };
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queued.push_back(std::move(job));
+	}
+
+	pending++;
+	wake.notify_one();
+}
+
+void TextureLoader::Request(const std::shared_ptr<TextureArray>& textureArray, const std::vector<std::string>& fileNames)
+{
+	Job job;
+	job.textureArray = textureArray;
+	job.fileNames = fileNames;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queued.push_back(std::move(job));
+	}
+
+	pending++;
+	wake.notify_one();
+}
+
+void TextureLoader::Work()
+{
+	for (;;)
+	{
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return stopping || !queued.empty(); });
+
+			if (stopping)
+			{
+				return;
+			}
+
+			job = std::move(queued.front());
+			queued.pop_front();
+		}
+
+		// nobody is waiting for it any more
+		if (job.texture.expired() && job.textureArray.expired())
+		{
+			pending--;
+			continue;
+		}
+
+		job.image = DecodeImage(job.fileNames);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		decoded.push_back(std::move(job));
+	}
+}
+
+void TextureLoader::Update()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		while (!decoded.empty())
+		{
+			ready.push_back(std::move(decoded.front()));
+			decoded.pop_front();
+		}
+	}
+
+	if (ready.empty())
+	{
+		return;
+	}
+
+	staging.BeginFrame();
+
+	// copied into the staging buffer now, handed to GL once it is committed
+	std::vector<std::pair<Job, std::vector<const void*>>> uploads;
+	unsigned spent = 0;
+
+	while (!ready.empty())
+	{
+		Job& job = ready.front();
+		const size_t size = job.image.GetSize();
+
+		if ((job.texture.expired() && job.textureArray.expired()) || job.image.width == 0)
+		{
+			// an image that failed to decode keeps its placeholder
+			ready.pop_front();
+			pending--;
+			continue;
+		}
+
+		if (size <= uploadBudget)
+		{
+			if (spent + size > uploadBudget)
+			{
+				break;
+			}
+
+			std::vector<const void*> sources;
+			bool staged = true;
+
+			for (const auto& level : job.image.levels)
+			{
+				const auto allocation = staging.Allocate((unsigned)level.size(), 4);
+
+				// the budget should leave room, but a short region must never be written past
+				if (!allocation.data)
+				{
+					staged = false;
+					break;
+				}
+
+				memcpy(allocation.data, level.data(), level.size());
+
+				sources.push_back((const void*)(size_t)allocation.offset);
+			}
+
+			if (staged)
+			{
+				spent += (unsigned)size;
+
+				uploads.emplace_back(std::move(job), std::move(sources));
+				ready.pop_front();
+				continue;
+			}
+		}
+
+		// larger than the whole staging buffer or not fitting its region, uploaded straight from memory on a frame
+		// of its own
+		if (spent > 0 || !uploads.empty())
+		{
+			break;
+		}
+
+		std::vector<const void*> sources;
+
+		for (const auto& level : job.image.levels)
+		{
+			sources.push_back(level.data());
+		}
+
+		Apply(job, sources);
+
+		ready.pop_front();
+		pending--;
+		break;
+	}
+
+	staging.Commit();
+
+	if (!uploads.empty())
+	{
+		GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.GetID());
+
+		for (const auto& [job, sources] : uploads)
+		{
+			Apply(job, sources);
+			pending--;
+		}
+
+		// every other upload reads client memory
+		GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	staging.EndFrame();
+}
+
+void TextureLoader::Apply(const Job& job, const std::vector<const void*>& levelSources)
+{
+	if (auto texture = job.texture.lock())
+	{
+		texture->SetImage(job.image, levelSources);
+	}
+	else if (auto textureArray = job.textureArray.lock())
+	{
+		textureArray->SetImage(job.image, levelSources);
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Texture.h"
+#include "buffers/DynamicRingBuffer.h"
+
+// Decodes images and builds their mips on a pool of worker threads, then uploads them on the GL thread through
+// a pixel unpack ring buffer, no more than uploadBudget bytes a frame. Requested textures keep their placeholder
+// until then, so loading never holds up a frame.
+class TextureLoader
+{
+public:
+	// 0 workers picks one less than the hardware threads
+	explicit TextureLoader(unsigned workers = 0, unsigned uploadBudget = 8 * 1024 * 1024);
+	~TextureLoader();
+
+	TextureLoader(const TextureLoader&) = delete;
+	TextureLoader& operator=(const TextureLoader&) = delete;
+
+	// the texture should hold a placeholder, only a weak reference is kept so dropping it cancels the upload
+	void Request(const std::shared_ptr<Texture>& texture, const std::string& fileName);
+	void Request(const std::shared_ptr<TextureArray>& textureArray, const std::vector<std::string>& fileNames);
+
+	// GL thread, once a frame: uploads decoded images until the budget is spent
+	void Update();
+
+	// requested images not uploaded yet
+	unsigned GetPending() const { return pending; }
+
+private:
+	struct Job
+	{
+		std::weak_ptr<Texture> texture;
+		std::weak_ptr<TextureArray> textureArray;
+		std::vector<std::string> fileNames;
+
+		DecodedImage image;
+	};
+
+	void Work();
+
+	// hands the mip levels to the texture, sources are pointers or unpack buffer offsets
+	static void Apply(const Job& job, const std::vector<const void*>& levelSources);
+
+	unsigned uploadBudget;
+	DynamicRingBuffer staging;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::deque<Job> queued;
+	std::deque<Job> decoded;
+	bool stopping = false;
+
+	std::vector<std::thread> workers;
+
+	// decoded jobs taken from the workers but not uploaded yet, GL thread only
+	std::deque<Job> ready;
+
+	std::atomic<unsigned> pending = 0;
+};
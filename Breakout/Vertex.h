@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
@@ -11,9 +13,15 @@ struct Vertex
 	glm::vec3 Normal;
 	// texCoords
 	glm::vec2 TexCoords;
-	// tangent
-	glm::vec3 Tangent;
-	// bitangent
-	glm::vec3 Bitangent;
 };
 
+// 16 byte vertex for meshes imported with VertexFormat::Compact
+struct CompactVertex
+{
+	// position quantized to 16 bits per axis inside the mesh bounds, w is padding
+	uint64_t Position;
+	// normal packed as signed 10:10:10:2
+	uint32_t Normal;
+	// texCoords as two half floats
+	uint32_t TexCoords;
+};
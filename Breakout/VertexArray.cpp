@@ -2,6 +2,8 @@
 
 #include <glad/glad.h>
 
+#include "GLStateCache.h"
+
 VertexArray::VertexArray()
 {
 	glGenVertexArrays(1, &id);
@@ -9,40 +11,60 @@ VertexArray::VertexArray()
 
 void VertexArray::Bind()
 {
-	glBindVertexArray(id);
+	GLStateCache::BindVertexArray(id);
 }
 
 void VertexArray::Unbind()
 {
-	glBindVertexArray(0);
+	GLStateCache::BindVertexArray(0);
 }
 
-void VertexArray::SetVertexBuffer(std::unique_ptr<VertexBuffer> vb)
+void VertexArray::SetVertexBuffer(std::shared_ptr<VertexBuffer> vb)
 {
 	Bind();
 	vb->Bind();
 
-	const auto& layout = vb->GetLayout();
-
-	auto i = 0;
-
-	for (const auto& element : layout)
-	{
-		glVertexAttribPointer(i, GetComponentCount(element.type), GetGLType(element.type),
-			GL_FALSE, layout.GetStride(), (void*)element.offset);
-
-		glEnableVertexAttribArray(i);
-
-		++i;
-	}
+	AddAttributes(vb->GetLayout(), 0);
 
 	vbo = std::move(vb);
 }
 
-void VertexArray::SetIndexBuffer(std::unique_ptr<IndexBuffer> ib)
+void VertexArray::SetIndexBuffer(std::shared_ptr<IndexBuffer> ib)
 {
 	Bind();
 	ib->Bind();
 
 	ibo = std::move(ib);
-}
\ No newline at end of file
+}
+
+void VertexArray::SetInstanceBuffer(unsigned buffer, const BufferLayout& layout)
+{
+	Bind();
+	GLStateCache::BindBuffer(GL_ARRAY_BUFFER, buffer);
+
+	AddAttributes(layout, 1);
+}
+
+void VertexArray::AddAttributes(const BufferLayout& layout, unsigned divisor)
+{
+
+	for (const auto& element : layout)
+	{
+		// matrices are passed as one attribute per column
+		const unsigned columns = element.type == Mat4 ? 4 : element.type == Mat3 ? 3 : 1;
+		const unsigned components = GetComponentCount(element.type) / columns;
+
+		for (unsigned column = 0; column < columns; column++)
+		{
+			const auto offset = element.offset + column * components * sizeof(float);
+
+			glVertexAttribPointer(attributeCount, components, GetGLType(element.type),
+				IsNormalized(element.type) ? GL_TRUE : GL_FALSE, layout.GetStride(), (void*)offset);
+
+			glEnableVertexAttribArray(attributeCount);
+			glVertexAttribDivisor(attributeCount, divisor);
+
+			++attributeCount;
+		}
+	}
+}
@@ -13,14 +13,26 @@ public:
 	void Bind();
 	void Unbind();
 
-	void SetVertexBuffer(std::unique_ptr<VertexBuffer> vb);
-	void SetIndexBuffer(std::unique_ptr<IndexBuffer> ib);
+	// buffers are shared so several vertex arrays can source the same mesh data
+	void SetVertexBuffer(std::shared_ptr<VertexBuffer> vb);
+	void SetIndexBuffer(std::shared_ptr<IndexBuffer> ib);
 
-	IndexBuffer* GetIBO() { return ibo.get(); }
+	// attributes of the instance buffer follow the vertex attributes and advance once per instance.
+	// The buffer is not owned, it is usually a DynamicRingBuffer with the frame's data picked by base instance
+	void SetInstanceBuffer(unsigned buffer, const BufferLayout& layout);
+
+	const std::shared_ptr<VertexBuffer>& GetVBO() { return vbo; }
+	const std::shared_ptr<IndexBuffer>& GetIBO() { return ibo; }
+
+	unsigned GetID() const { return id; }
 
 private:
+	// reads the attributes from the buffer bound to GL_ARRAY_BUFFER
+	void AddAttributes(const BufferLayout& layout, unsigned divisor);
+
 	unsigned id;
+	unsigned attributeCount = 0;
 
-	std::unique_ptr<VertexBuffer> vbo;
-	std::unique_ptr<IndexBuffer> ibo;
+	std::shared_ptr<VertexBuffer> vbo;
+	std::shared_ptr<IndexBuffer> ibo;
 };
@@ -40,6 +40,15 @@ unsigned SizeOfType(ShaderDataType type)
 
 	case Mat4:
 		return 4 * 4 * sizeof(float);
+
+	case Half2:
+		return 2 * sizeof(unsigned short);
+
+	case UShort4Norm:
+		return 4 * sizeof(unsigned short);
+
+	case Int2101010Norm:
+		return sizeof(unsigned);
 	}
 
 	return 0;
@@ -63,6 +72,13 @@ unsigned GetComponentCount(ShaderDataType type)
 
 	case Mat4:
 		return 4 * 4;
+
+	case Half2:
+		return 2;
+
+	case UShort4Norm:
+	case Int2101010Norm:
+		return 4;
 	}
 
 	return 0;
@@ -78,7 +94,21 @@ unsigned GetGLType(ShaderDataType type)
 	case Mat3:
 	case Mat4:
 		return GL_FLOAT;
+
+	case Half2:
+		return GL_HALF_FLOAT;
+
+	case UShort4Norm:
+		return GL_UNSIGNED_SHORT;
+
+	case Int2101010Norm:
+		return GL_INT_2_10_10_10_REV;
 	}
 
 	return 0;
+}
+
+bool IsNormalized(ShaderDataType type)
+{
+	return type == UShort4Norm || type == Int2101010Norm;
 }
\ No newline at end of file
@@ -9,7 +9,12 @@ enum ShaderDataType
 	Float2,
 	Float3,
 	Mat3,
-	Mat4
+	Mat4,
+
+	// compact vertex attributes, read by the shader as floats
+	Half2,
+	UShort4Norm,
+	Int2101010Norm
 };
 
 struct BufferElement
@@ -48,4 +53,7 @@ private:
 
 unsigned SizeOfType(ShaderDataType type);
 unsigned GetComponentCount(ShaderDataType type);
-unsigned GetGLType(ShaderDataType type);
\ No newline at end of file
+unsigned GetGLType(ShaderDataType type);
+
+// integer types are mapped onto [0, 1] or [-1, 1] when the shader reads them
+bool IsNormalized(ShaderDataType type);
\ No newline at end of file
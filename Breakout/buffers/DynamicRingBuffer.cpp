@@ -0,0 +1,132 @@
+#include "DynamicRingBuffer.h"
+
+#include <iostream>
+
+#include <glad/glad.h>
+
+#include "../GLStateCache.h"
+
+DynamicRingBuffer::DynamicRingBuffer(unsigned regionSize)
+    : regionSize(regionSize)
+{
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    if (alignment > 0)
+    {
+        uniformAlignment = (unsigned)alignment;
+    }
+
+    alignment = 0;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    if (alignment > 0)
+    {
+        storageAlignment = (unsigned)alignment;
+    }
+
+    glGenBuffers(1, &id);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, id);
+
+    if (GLAD_GL_VERSION_4_4)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glBufferStorage(GL_ARRAY_BUFFER, (GLsizeiptr)regionSize * frameRegions, nullptr, flags);
+        mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)regionSize * frameRegions, flags);
+    }
+
+    if (!mapped)
+    {
+        // one region is enough, orphaning gives every frame fresh storage
+        glBufferData(GL_ARRAY_BUFFER, regionSize, nullptr, GL_STREAM_DRAW);
+        staging.resize(regionSize);
+    }
+}
+
+DynamicRingBuffer::~DynamicRingBuffer()
+{
+    for (GLsync& fence : fences)
+    {
+        if (fence)
+        {
+            glDeleteSync(fence);
+        }
+    }
+
+    if (mapped)
+    {
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, id);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    GLStateCache::ForgetBuffer(id);
+    glDeleteBuffers(1, &id);
+}
+
+void DynamicRingBuffer::BeginFrame()
+{
+    used = 0;
+
+    if (!mapped)
+    {
+        return;
+    }
+
+    region = (region + 1) % frameRegions;
+
+    GLsync& fence = fences[region];
+
+    if (fence)
+    {
+        // the GPU is normally two frames behind at most, so this rarely waits
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+        {
+        }
+
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+DynamicRingBuffer::Allocation DynamicRingBuffer::Allocate(unsigned size, unsigned alignment)
+{
+    const unsigned base = mapped ? region * regionSize : 0;
+    const unsigned offset = (base + used + alignment - 1) / alignment * alignment;
+
+    if (offset + size > base + regionSize)
+    {
+        // once per buffer, an undersized region fails every frame
+        if (!reportedFull)
+        {
+            std::cout << "DynamicRingBuffer: frame region of " << regionSize << " bytes is full, allocations fail until a later frame" << std::endl;
+            reportedFull = true;
+        }
+
+        return { nullptr, 0 };
+    }
+
+    used = offset + size - base;
+
+    return { mapped ? mapped + offset : staging.data() + offset, offset };
+}
+
+void DynamicRingBuffer::Commit()
+{
+    if (mapped || used == 0)
+    {
+        return;
+    }
+
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, id);
+    glBufferData(GL_ARRAY_BUFFER, regionSize, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, used, staging.data());
+}
+
+void DynamicRingBuffer::EndFrame()
+{
+    if (mapped)
+    {
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+struct __GLsync;
+
+// One buffer object for data rewritten every frame, split into frameRegions regions used round robin.
+// With GL 4.4 the buffer is created with glBufferStorage and stays persistently mapped, so writes go
+// straight into GPU visible memory; a fence per region keeps the CPU from overwriting data still being read.
+// Older contexts write into a CPU copy that Commit uploads after orphaning the buffer.
+class DynamicRingBuffer
+{
+public:
+	static const unsigned frameRegions = 3;
+
+	struct Allocation
+	{
+		// where to write, nullptr when the frame's region is full
+		void* data;
+		// from the start of the buffer, for attribute offsets, base instances and glBindBufferRange
+		unsigned offset;
+	};
+
+	// regionSize bytes are available to each frame
+	explicit DynamicRingBuffer(unsigned regionSize);
+	~DynamicRingBuffer();
+
+	DynamicRingBuffer(const DynamicRingBuffer&) = delete;
+	DynamicRingBuffer& operator=(const DynamicRingBuffer&) = delete;
+
+	// moves to the next region, waiting for the GPU if it is still reading it
+	void BeginFrame();
+
+	// the offset is a multiple of alignment, which does not have to be a power of two
+	Allocation Allocate(unsigned size, unsigned alignment = 16);
+
+	// makes the frame's writes visible to GL, call before the draws that read them
+	void Commit();
+
+	// fences the frame's region, call after the draws that read it
+	void EndFrame();
+
+	unsigned GetID() const { return id; }
+	bool IsPersistent() const { return mapped != nullptr; }
+
+	// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, uniform blocks bound from the buffer need it
+	unsigned GetUniformAlignment() const { return uniformAlignment; }
+
+	// GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, the same for storage blocks
+	unsigned GetStorageAlignment() const { return storageAlignment; }
+
+private:
+	unsigned id = 0;
+	unsigned regionSize;
+	unsigned region = 0;
+	unsigned used = 0;
+	unsigned uniformAlignment = 256;
+	unsigned storageAlignment = 256;
+	bool reportedFull = false;
+
+	// persistent path
+	unsigned char* mapped = nullptr;
+	__GLsync* fences[frameRegions] = {};
+
+	// orphaning path, the frame's data until Commit
+	std::vector<unsigned char> staging;
+};
@@ -2,20 +2,30 @@
 
 #include <glad/glad.h>
 
-IndexBuffer::IndexBuffer(unsigned* data, int count)
-    : _count(count)
+#include "../GLStateCache.h"
+
+IndexBuffer::IndexBuffer(const unsigned* data, int count)
+    : _count(count), _type(GL_UNSIGNED_INT), _indexSize(sizeof(unsigned))
 {
     glGenBuffers(1, &id);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
+    GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned), data, GL_STATIC_DRAW);
 }
 
+IndexBuffer::IndexBuffer(const unsigned short* data, int count)
+    : _count(count), _type(GL_UNSIGNED_SHORT), _indexSize(sizeof(unsigned short))
+{
+    glGenBuffers(1, &id);
+    GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned short), data, GL_STATIC_DRAW);
+}
+
 void IndexBuffer::Bind()
 {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
+    GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
 }
 
 void IndexBuffer::Unbind()
 {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
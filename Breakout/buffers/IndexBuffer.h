@@ -3,13 +3,24 @@
 class IndexBuffer
 {
 public:
-	IndexBuffer(unsigned* data, int size);
+	IndexBuffer(const unsigned* data, int size);
+
+	// 16 bit indices, for meshes with at most 65536 vertices
+	IndexBuffer(const unsigned short* data, int size);
 
 	void Bind();
 	void Unbind();
 	int GetCount() const { return _count; }
 
+	// GL_UNSIGNED_INT or GL_UNSIGNED_SHORT, to pass to the draw call
+	unsigned GetType() const { return _type; }
+
+	// bytes per index, to turn an index into a buffer offset
+	unsigned GetIndexSize() const { return _indexSize; }
+
 private:
 	unsigned int id;
 	int _count;
+	unsigned _type;
+	unsigned _indexSize;
 };
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "StorageBuffer.h"
+
+#include <glad/glad.h>
+
+#include "../GLStateCache.h"
+
+StorageBuffer::StorageBuffer(int size)
+    : _size(size)
+{
+    glGenBuffers(1, &id);
+    GLStateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, id);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_COPY);
+}
+
+StorageBuffer::~StorageBuffer()
+{
+    GLStateCache::ForgetBuffer(id);
+    glDeleteBuffers(1, &id);
+}
+
+void StorageBuffer::Reserve(int size)
+{
+    if (size <= _size)
+    {
+        return;
+    }
+
+    // headroom so a growing level does not reallocate every frame
+    _size = size + size / 2;
+
+    GLStateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, id);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, _size, nullptr, GL_DYNAMIC_COPY);
+}
+
+void StorageBuffer::SetData(const void* data, int size, int offset)
+{
+    GLStateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, id);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
+}
+
+void StorageBuffer::BindBase(unsigned binding)
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, id);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// A buffer written and read by shaders through storage blocks, and by GL as indirect commands or vertex attributes
+class StorageBuffer
+{
+public:
+	// size bytes of uninitialised storage
+	explicit StorageBuffer(int size);
+	~StorageBuffer();
+
+	StorageBuffer(const StorageBuffer&) = delete;
+	StorageBuffer& operator=(const StorageBuffer&) = delete;
+
+	// grows to at least size bytes, the contents are lost when it does
+	void Reserve(int size);
+
+	void SetData(const void* data, int size, int offset = 0);
+
+	// attaches the whole buffer to a shader storage block binding point
+	void BindBase(unsigned binding);
+
+	unsigned GetID() const { return id; }
+	int GetSize() const { return _size; }
+
+private:
+	unsigned int id;
+	int _size;
+};
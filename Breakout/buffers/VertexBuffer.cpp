@@ -2,19 +2,44 @@
 
 #include <glad/glad.h>
 
-VertexBuffer::VertexBuffer(void* data, int size)
+#include "../GLStateCache.h"
+
+VertexBuffer::VertexBuffer(const void* data, int size)
+    : _size(size)
 {
     glGenBuffers(1, &id);
-    glBindBuffer(GL_ARRAY_BUFFER, id);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, id);
     glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
 }
 
+VertexBuffer::VertexBuffer(int size)
+    : _size(size)
+{
+    glGenBuffers(1, &id);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, id);
+    glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+}
+
 void VertexBuffer::Bind()
 {
-    glBindBuffer(GL_ARRAY_BUFFER, id);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, id);
 }
 
 void VertexBuffer::Unbind()
 {
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void VertexBuffer::SetData(const void* data, int size)
+{
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, id);
+
+    if (size > _size)
+    {
+        // reallocate with some headroom so a growing level does not resize every frame
+        _size = size + size / 2;
+        glBufferData(GL_ARRAY_BUFFER, _size, nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
 }
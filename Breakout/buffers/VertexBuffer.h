@@ -5,11 +5,17 @@
 class VertexBuffer
 {
 public:
-	VertexBuffer(void* data, int size);
+	VertexBuffer(const void* data, int size);
+
+	// creates an empty buffer for data that is rewritten every frame
+	explicit VertexBuffer(int size);
 
 	void Bind();
 	void Unbind();
 
+	// uploads new contents, growing the buffer when it is too small
+	void SetData(const void* data, int size);
+
 	void SetLayout(const BufferLayout& layout)
 	{
 		this->layout = layout;
@@ -20,8 +26,11 @@ public:
 		return layout;
 	}
 
+	int GetSize() const { return _size; }
+
 private:
 	unsigned int id;
+	int _size;
 
 	BufferLayout layout;
-};
\ No newline at end of file
+};
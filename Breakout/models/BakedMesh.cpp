@@ -0,0 +1,275 @@
+#include "BakedMesh.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "../buffers/BufferLayout.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// every section starts on this boundary, so the mapped pointers are aligned for any vertex or index type
+	const uint64_t sectionAlignment = 16;
+
+	uint64_t Align(uint64_t offset)
+	{
+		return (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+	}
+
+	bool InsideFile(uint64_t offset, uint64_t length, uint64_t size)
+	{
+		return offset % sectionAlignment == 0 && offset <= size && length <= size - offset;
+	}
+}
+
+std::string BakedMeshPath(const std::string& path, VertexFormat format, unsigned lodLevels)
+{
+	std::string baked = path;
+
+	// only an extension of the file name itself, not a dot in one of the directories
+	const size_t dot = baked.find_last_of('.');
+	const size_t separator = baked.find_last_of("/\\");
+
+	if (dot != std::string::npos && (separator == std::string::npos || dot > separator))
+	{
+		baked.erase(dot);
+	}
+
+	if (format == VertexFormat::Compact)
+	{
+		baked += ".compact";
+	}
+
+	if (lodLevels > 0)
+	{
+		baked += ".lod" + std::to_string(lodLevels);
+	}
+
+	return baked + ".mesh";
+}
+
+bool WriteBakedMesh(const std::string& path, const MeshData& mesh, unsigned lodLevels)
+{
+	const bool compact = mesh.format == VertexFormat::Compact;
+	const uint32_t vertexCount = (uint32_t)(compact ? mesh.compactVertices.size() : mesh.vertices.size());
+
+	BakedMeshHeader header = {};
+	header.magic = bakedMeshMagic;
+	header.version = bakedMeshVersion;
+	header.format = (uint32_t)mesh.format;
+	header.lodLevels = lodLevels;
+	header.vertexCount = vertexCount;
+	header.vertexStride = compact ? sizeof(CompactVertex) : sizeof(Vertex);
+	header.indexCount = (uint32_t)mesh.indices.size();
+
+	// the same choice Mesh makes for imported meshes
+	header.indexSize = vertexCount <= 0x10000 ? sizeof(uint16_t) : sizeof(uint32_t);
+
+	header.attributeCount = 3;
+	header.attributes[0] = compact ? UShort4Norm : Float3;
+	header.attributes[1] = compact ? Int2101010Norm : Float3;
+	header.attributes[2] = compact ? Half2 : Float2;
+
+	header.lodCount = (uint32_t)mesh.lods.size();
+
+	memcpy(header.boundsMin, &mesh.bounds.min, sizeof(header.boundsMin));
+	memcpy(header.boundsMax, &mesh.bounds.max, sizeof(header.boundsMax));
+	memcpy(header.boundsCentre, &mesh.bounds.centre, sizeof(header.boundsCentre));
+	header.boundsRadius = mesh.bounds.radius;
+	memcpy(header.dequantize, &mesh.dequantize, sizeof(header.dequantize));
+
+	header.lodOffset = Align(sizeof(header));
+	header.vertexOffset = Align(header.lodOffset + header.lodCount * sizeof(MeshLod));
+	header.indexOffset = Align(header.vertexOffset + (uint64_t)header.vertexCount * header.vertexStride);
+
+	std::vector<uint16_t> shortIndices;
+
+	if (header.indexSize == sizeof(uint16_t))
+	{
+		shortIndices.assign(mesh.indices.begin(), mesh.indices.end());
+	}
+
+	// written under a temporary name first so a crash never leaves a truncated bake behind
+	std::filesystem::path temporary = path;
+	temporary += ".tmp";
+
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+
+		if (!file)
+		{
+			std::cout << "BakedMesh: cannot write " << temporary.string() << std::endl;
+			return false;
+		}
+
+		const char padding[sectionAlignment] = {};
+
+		auto write = [&](uint64_t offset, const void* data, uint64_t length)
+		{
+			file.write(padding, offset - (uint64_t)file.tellp());
+			file.write((const char*)data, length);
+		};
+
+		write(0, &header, sizeof(header));
+		write(header.lodOffset, mesh.lods.data(), header.lodCount * sizeof(MeshLod));
+
+		if (compact)
+		{
+			write(header.vertexOffset, mesh.compactVertices.data(), (uint64_t)vertexCount * header.vertexStride);
+		}
+		else
+		{
+			write(header.vertexOffset, mesh.vertices.data(), (uint64_t)vertexCount * header.vertexStride);
+		}
+
+		if (header.indexSize == sizeof(uint16_t))
+		{
+			write(header.indexOffset, shortIndices.data(), shortIndices.size() * sizeof(uint16_t));
+		}
+		else
+		{
+			write(header.indexOffset, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+		}
+
+		// closing flushes the last of the data, which can fail as well
+		file.close();
+
+		if (!file)
+		{
+			std::cout << "BakedMesh: writing " << temporary.string() << " failed" << std::endl;
+
+			std::error_code error;
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporary, path, error);
+
+	return !error;
+}
+
+BakedMeshFile::~BakedMeshFile()
+{
+	Close();
+}
+
+bool BakedMeshFile::Open(const std::string& path)
+{
+	Close();
+
+#ifdef _WIN32
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		file = nullptr;
+		return false;
+	}
+
+	LARGE_INTEGER fileSize = {};
+
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart >= (LONGLONG)sizeof(BakedMeshHeader))
+	{
+		size = (uint64_t)fileSize.QuadPart;
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+
+	if (mapping)
+	{
+		data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	}
+#else
+	const int descriptor = open(path.c_str(), O_RDONLY);
+
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat status = {};
+
+	if (fstat(descriptor, &status) == 0 && status.st_size >= (off_t)sizeof(BakedMeshHeader))
+	{
+		size = (uint64_t)status.st_size;
+
+		void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+		if (mapped != MAP_FAILED)
+		{
+			data = (const unsigned char*)mapped;
+		}
+	}
+
+	// the mapping keeps its own reference to the file
+	close(descriptor);
+#endif
+
+	if (!data)
+	{
+		Close();
+		return false;
+	}
+
+	const BakedMeshHeader& header = GetHeader();
+
+	const bool valid = header.magic == bakedMeshMagic && header.version == bakedMeshVersion
+		&& (header.indexSize == sizeof(uint16_t) || header.indexSize == sizeof(uint32_t))
+		&& header.attributeCount <= bakedMeshMaxAttributes
+		&& InsideFile(header.lodOffset, (uint64_t)header.lodCount * sizeof(MeshLod), size)
+		&& InsideFile(header.vertexOffset, (uint64_t)header.vertexCount * header.vertexStride, size)
+		&& InsideFile(header.indexOffset, (uint64_t)header.indexCount * header.indexSize, size);
+
+	if (!valid)
+	{
+		std::cout << "BakedMesh: " << path << " is not a valid version " << bakedMeshVersion << " bake" << std::endl;
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void BakedMeshFile::Close()
+{
+#ifdef _WIN32
+	if (data)
+	{
+		UnmapViewOfFile(data);
+	}
+
+	if (mapping)
+	{
+		CloseHandle(mapping);
+	}
+
+	if (file)
+	{
+		CloseHandle(file);
+	}
+
+	file = nullptr;
+	mapping = nullptr;
+#else
+	if (data)
+	{
+		munmap((void*)data, size);
+	}
+#endif
+
+	data = nullptr;
+	size = 0;
+}
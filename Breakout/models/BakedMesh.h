@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "MeshData.h"
+
+// A mesh baked offline by the MeshBake tool, laid out so MeshCache can map the file and hand the vertex and
+// index ranges straight to glBufferData. The header is followed by lodCount MeshLods, the vertices and the
+// indices, each at its offset from the start of the file. Little endian only, like every target of the game.
+
+// "BKMH", bumped with the version whenever the layout changes
+const uint32_t bakedMeshMagic = 0x484D4B42;
+const uint32_t bakedMeshVersion = 1;
+
+const uint32_t bakedMeshMaxAttributes = 4;
+
+struct BakedMeshHeader
+{
+	uint32_t magic;
+	uint32_t version;
+
+	// the VertexFormat and lodLevels it was baked with, a request for anything else falls back to importing
+	uint32_t format;
+	uint32_t lodLevels;
+
+	uint32_t vertexCount;
+	uint32_t vertexStride;
+	uint32_t indexCount;
+	// 2 when every vertex can be addressed with 16 bits, otherwise 4
+	uint32_t indexSize;
+
+	// the vertex layout, a ShaderDataType for aPos, aNorm and aTexCoords in that order
+	uint32_t attributeCount;
+	uint32_t attributes[bakedMeshMaxAttributes];
+
+	uint32_t lodCount;
+
+	float boundsMin[3];
+	float boundsMax[3];
+	float boundsCentre[3];
+	float boundsRadius;
+
+	// column major
+	float dequantize[16];
+
+	uint64_t lodOffset;
+	uint64_t vertexOffset;
+	uint64_t indexOffset;
+};
+
+// where the bake of path for the format and lodLevels lives, "cube.obj" baked compact with 2 levels is "cube.compact.lod2.mesh"
+std::string BakedMeshPath(const std::string& path, VertexFormat format, unsigned lodLevels);
+
+// writes the mesh in the baked layout, false if the file cannot be written
+bool WriteBakedMesh(const std::string& path, const MeshData& mesh, unsigned lodLevels);
+
+// Read-only mapping of a baked mesh file. The pointers stay valid until the object is destroyed,
+// nothing is copied out of the file
+class BakedMeshFile
+{
+public:
+	BakedMeshFile() = default;
+	~BakedMeshFile();
+
+	BakedMeshFile(const BakedMeshFile&) = delete;
+	BakedMeshFile& operator=(const BakedMeshFile&) = delete;
+
+	// maps the file and checks the header and that every range lies inside it, false if it is missing or invalid
+	bool Open(const std::string& path);
+
+	const BakedMeshHeader& GetHeader() const { return *(const BakedMeshHeader*)data; }
+	const MeshLod* GetLods() const { return (const MeshLod*)(data + GetHeader().lodOffset); }
+	const void* GetVertices() const { return data + GetHeader().vertexOffset; }
+	const void* GetIndices() const { return data + GetHeader().indexOffset; }
+
+private:
+	void Close();
+
+	const unsigned char* data = nullptr;
+	uint64_t size = 0;
+
+#ifdef _WIN32
+	void* file = nullptr;
+	void* mapping = nullptr;
+#endif
+};
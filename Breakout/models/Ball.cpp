@@ -1,9 +0,0 @@
-#include "Ball.h"
-
-Ball::Ball()
-{
-	position = { 0.0f, 0.0f, 0.0f };
-	scale = { 1.0f, 1.0f, 0.0f };
-	velocity = { 5.5f, 10.0f };
-	colour = { 1.0f, 1.0f, 1.0f };
-}
\ No newline at end of file
@@ -12,7 +12,7 @@ public:
 	glm::vec3 scale;
 	glm::vec3 colour;
 
-	Texture texture;
+	std::shared_ptr<Texture> texture;
 
 	float rotation;
 	
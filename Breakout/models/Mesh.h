@@ -5,14 +5,17 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "../GLStateCache.h"
 #include "../Shader.h"
 
+#include <cfloat>
 #include <string>
 #include <vector>
 
 
 #include "../Vertex.h"
 #include "../VertexArray.h"
+#include "MeshData.h"
 
 struct TextureInfo
 {
@@ -30,7 +33,34 @@ public:
 		this->_textures = textures;
 
 		// now that we have all the required data, set the vertex buffers and its attribute pointers.
-		setupMesh(vertices, indices);
+		setupMesh(vertices.data(), vertices.size() * sizeof(Vertex), indices,
+			{
+				{"aPos", Float3},
+				{"aNorm", Float3},
+				{"aTexCoords", Float2}
+			}
+		);
+	}
+
+	// quantized vertices, dequantize maps their unit cube positions back into model space
+	Mesh(std::vector<CompactVertex> vertices, std::vector<unsigned int> indices, const glm::mat4& dequantize)
+		: _dequantize(dequantize)
+	{
+		setupMesh(vertices.data(), vertices.size() * sizeof(CompactVertex), indices,
+			{
+				{"aPos", UShort4Norm},
+				{"aNorm", Int2101010Norm},
+				{"aTexCoords", Half2}
+			}
+		);
+	}
+
+	// vertices and indices laid out as they go into the buffers, indexSize bytes per index.
+	// Nothing is kept, so the data can come straight from a mapped file
+	Mesh(const void* vertices, size_t size, const void* indices, unsigned indexCount, unsigned indexSize, const BufferLayout& layout, const glm::mat4& dequantize)
+		: _dequantize(dequantize)
+	{
+		setupBuffers(vertices, size, indices, indexCount, indexSize, layout);
 	}
 
 	// render the mesh
@@ -44,8 +74,6 @@ public:
 
 		for (unsigned int i = 0; i < _textures.size(); i++)
 		{
-			glActiveTexture(GL_TEXTURE0 + i); // active proper texture unit before binding
-
 			// retrieve texture number (the N in diffuse_textureN)
 			std::string number;
 			std::string name = _textures[i].type;
@@ -70,44 +98,92 @@ public:
 			// now set the sampler to the correct texture unit
 			shader.setInt(name + number, i);
 
-			// and finally bind the texture
-			glBindTexture(GL_TEXTURE_2D, _textures[i].id);
+			// and finally bind the texture to its unit
+			GLStateCache::BindTexture(i, GL_TEXTURE_2D, _textures[i].id);
 		}
 
 		// draw mesh
+		Draw();
+	}
+
+	// render the geometry only, with whatever textures are currently bound
+	void Draw()
+	{
 		_vao->Bind();
-		glDrawElements(GL_TRIANGLES, _vao->GetIBO()->GetCount(), GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
+		glDrawElements(GL_TRIANGLES, _lods[0].count, _vao->GetIBO()->GetType(), 0);
+	}
+
+	VertexArray* GetVAO() { return _vao.get(); }
+
+	// applied before the model matrix, the identity unless the positions are quantized
+	const glm::mat4& GetDequantize() const { return _dequantize; }
 
-		// always good practice to set everything back to defaults once configured.
-		glActiveTexture(GL_TEXTURE0);
+	void SetBounds(const MeshBounds& bounds) { _bounds = bounds; }
+	const MeshBounds& GetBounds() const { return _bounds; }
+
+	// ordered from the full mesh down, the ranges have to lie inside the index buffer
+	void SetLods(const std::vector<MeshLod>& lods) { _lods = lods; }
+	const std::vector<MeshLod>& GetLods() const { return _lods; }
+
+	// the coarsest level whose maxScreenSize is still above screenSize
+	unsigned SelectLod(float screenSize) const
+	{
+		unsigned lod = 0;
+
+		while (lod + 1 < _lods.size() && screenSize < _lods[lod + 1].maxScreenSize)
+		{
+			lod++;
+		}
+
+		return lod;
 	}
 
 private:
 	std::vector<TextureInfo> _textures;
 	std::unique_ptr<VertexArray> _vao;
+	glm::mat4 _dequantize = glm::mat4(1.0f);
+	MeshBounds _bounds;
+	std::vector<MeshLod> _lods;
+
+	void setupMesh(void* vertices, size_t size, std::vector<unsigned int>& indices, const BufferLayout& layout)
+	{
+		// half the index memory whenever every vertex can be addressed with 16 bits
+		if (size / layout.GetStride() <= 0x10000)
+		{
+			std::vector<unsigned short> shortIndices(indices.begin(), indices.end());
+			setupBuffers(vertices, size, shortIndices.data(), (unsigned)shortIndices.size(), sizeof(unsigned short), layout);
+		}
+		else
+		{
+			setupBuffers(vertices, size, indices.data(), (unsigned)indices.size(), sizeof(unsigned), layout);
+		}
+	}
 
-	void setupMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+	void setupBuffers(const void* vertices, size_t size, const void* indices, unsigned indexCount, unsigned indexSize, const BufferLayout& layout)
 	{
 		_vao = std::make_unique<VertexArray>();
 		_vao->Bind();
 
-		auto vbo = std::make_unique<VertexBuffer>(&vertices[0], vertices.size() * sizeof(Vertex));
+		auto vbo = std::make_unique<VertexBuffer>(vertices, (int)size);
 		vbo->Bind();
 
-		vbo->SetLayout(
-			{
-				{"aPos", Float3},
-				{"aNorm", Float3},
-				{"aTexCoords", Float2},
-				{"aTangent", Float3},
-				{"aBitangent", Float3}
-			}
-		);
+		vbo->SetLayout(layout);
+
+		std::unique_ptr<IndexBuffer> ibo;
+
+		if (indexSize == sizeof(unsigned short))
+		{
+			ibo = std::make_unique<IndexBuffer>((const unsigned short*)indices, (int)indexCount);
+		}
+		else
+		{
+			ibo = std::make_unique<IndexBuffer>((const unsigned*)indices, (int)indexCount);
+		}
 
-		auto ibo = std::make_unique<IndexBuffer>(&indices[0], indices.size());
 		ibo->Bind();
 
+		_lods = { { 0, indexCount, FLT_MAX } };
+
 		_vao->SetVertexBuffer(std::move(vbo));
 		_vao->SetIndexBuffer(std::move(ibo));
 	}
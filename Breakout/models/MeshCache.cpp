@@ -0,0 +1,171 @@
+#include "MeshCache.h"
+#include "BakedMesh.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+std::shared_ptr<Mesh> MeshCache::Load(const std::string& path, VertexFormat format, unsigned lodLevels)
+{
+	std::string key = format == VertexFormat::Compact ? path + "#compact" : path;
+
+	if (lodLevels > 0)
+	{
+		key += "#lod" + std::to_string(lodLevels);
+	}
+
+	const auto cached = meshes.find(key);
+
+	if (cached != meshes.end())
+	{
+		return cached->second;
+	}
+
+	std::shared_ptr<Mesh> mesh = LoadBaked(path, format, lodLevels);
+
+	if (!mesh)
+	{
+		mesh = Import(path, format, lodLevels);
+	}
+
+	if (!mesh)
+	{
+		std::cout << "Failed to load mesh " << path << std::endl;
+		return nullptr;
+	}
+
+	meshes[key] = mesh;
+
+	return mesh;
+}
+
+std::shared_ptr<Mesh> MeshCache::LoadBaked(const std::string& path, VertexFormat format, unsigned lodLevels)
+{
+	const std::string bakedPath = BakedMeshPath(path, format, lodLevels);
+
+	BakedMeshFile file;
+
+	if (!file.Open(bakedPath))
+	{
+		return nullptr;
+	}
+
+	const BakedMeshHeader& header = file.GetHeader();
+
+	if (header.format != (uint32_t)format || header.lodLevels != lodLevels)
+	{
+		std::cout << "Baked mesh " << bakedPath << " was baked for another format, importing " << path << std::endl;
+		return nullptr;
+	}
+
+	if (header.attributeCount != 3 || header.lodCount == 0)
+	{
+		return nullptr;
+	}
+
+	for (uint32_t i = 0; i < header.attributeCount; i++)
+	{
+		if (header.attributes[i] > Int2101010Norm)
+		{
+			return nullptr;
+		}
+	}
+
+	// the shaders read position, normal and texture coordinates from locations 0 to 2
+	const BufferLayout layout =
+	{
+		{"aPos", (ShaderDataType)header.attributes[0]},
+		{"aNorm", (ShaderDataType)header.attributes[1]},
+		{"aTexCoords", (ShaderDataType)header.attributes[2]}
+	};
+
+	if (layout.GetStride() != header.vertexStride)
+	{
+		return nullptr;
+	}
+
+	const MeshLod* lods = file.GetLods();
+
+	for (uint32_t i = 0; i < header.lodCount; i++)
+	{
+		if (lods[i].firstIndex > header.indexCount || lods[i].count > header.indexCount - lods[i].firstIndex)
+		{
+			return nullptr;
+		}
+	}
+
+	// a stale or corrupted bake must not make the GPU read past the vertices
+	uint32_t maxIndex = 0;
+
+	if (header.indexSize == sizeof(uint16_t))
+	{
+		const uint16_t* indices = (const uint16_t*)file.GetIndices();
+
+		for (uint32_t i = 0; i < header.indexCount; i++)
+		{
+			maxIndex = std::max<uint32_t>(maxIndex, indices[i]);
+		}
+	}
+	else
+	{
+		const uint32_t* indices = (const uint32_t*)file.GetIndices();
+
+		for (uint32_t i = 0; i < header.indexCount; i++)
+		{
+			maxIndex = std::max(maxIndex, indices[i]);
+		}
+	}
+
+	if (header.indexCount > 0 && maxIndex >= header.vertexCount)
+	{
+		std::cout << "Baked mesh " << bakedPath << " indexes past its " << header.vertexCount << " vertices, importing " << path << std::endl;
+		return nullptr;
+	}
+
+	glm::mat4 dequantize;
+	memcpy(&dequantize, header.dequantize, sizeof(dequantize));
+
+	// the mapped ranges go to glBufferData as they are, the file is unmapped when it goes out of scope
+	auto mesh = std::make_shared<Mesh>(file.GetVertices(), (size_t)header.vertexCount * header.vertexStride,
+		file.GetIndices(), header.indexCount, header.indexSize, layout, dequantize);
+
+	MeshBounds bounds;
+	bounds.min = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+	bounds.max = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+	bounds.centre = glm::vec3(header.boundsCentre[0], header.boundsCentre[1], header.boundsCentre[2]);
+	bounds.radius = header.boundsRadius;
+
+	mesh->SetBounds(bounds);
+	mesh->SetLods(std::vector<MeshLod>(lods, lods + header.lodCount));
+
+	std::cout << "Loaded baked mesh " << bakedPath << ": " << header.vertexCount << " vertices, "
+		<< header.lodCount << " levels of detail" << std::endl;
+
+	return mesh;
+}
+
+std::shared_ptr<Mesh> MeshCache::Import(const std::string& path, VertexFormat format, unsigned lodLevels)
+{
+	MeshData data;
+
+	if (!ImportMesh(path, format, lodLevels, data))
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<Mesh> mesh;
+
+	if (format == VertexFormat::Compact)
+	{
+		mesh = std::make_shared<Mesh>(std::move(data.compactVertices), std::move(data.indices), data.dequantize);
+	}
+	else
+	{
+		mesh = std::make_shared<Mesh>(std::move(data.vertices), std::move(data.indices), std::vector<TextureInfo>());
+	}
+
+	mesh->SetBounds(data.bounds);
+	mesh->SetLods(data.lods);
+
+	return mesh;
+}
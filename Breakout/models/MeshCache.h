@@ -0,0 +1,28 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Mesh.h"
+
+// Loads each mesh file once and hands out shared handles to its GPU buffers
+class MeshCache
+{
+public:
+	// returns the cached mesh for the path, loading it on first use (nullptr if that fails).
+	// A bake of the path from BakedMeshPath is mapped and uploaded as it is, otherwise the file is imported with Assimp.
+	// lodLevels simplified levels of detail are generated after the full mesh
+	std::shared_ptr<Mesh> Load(const std::string& path, VertexFormat format = VertexFormat::Full, unsigned lodLevels = 0);
+
+	size_t GetSize() const { return meshes.size(); }
+
+private:
+	// nullptr when there is no bake for the format and lodLevels or it is invalid
+	static std::shared_ptr<Mesh> LoadBaked(const std::string& path, VertexFormat format, unsigned lodLevels);
+
+	static std::shared_ptr<Mesh> Import(const std::string& path, VertexFormat format, unsigned lodLevels);
+
+	std::unordered_map<std::string, std::shared_ptr<Mesh>> meshes;
+};
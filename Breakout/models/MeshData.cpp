@@ -0,0 +1,233 @@
+#include "MeshData.h"
+#include "MeshOptimizer.h"
+
+#include <cfloat>
+#include <iostream>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+namespace
+{
+	// screen size below which the first simplified level is used, each further level quarters it
+	const float firstLodScreenSize = 0.1f;
+
+	bool Import(const std::string& path, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		//Creates an assimp importer
+		Assimp::Importer importer;
+
+		//Creates a assimp scene and imports the model
+		const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs /*| aiProcess_CalcTangentSpace*/);
+
+		//Error checkinig the assimp scene
+		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode || scene->mNumMeshes == 0)
+		{
+			return false;
+		}
+
+		//Creates a assimp mech from the scene rootnode
+		aiMesh* mesh = scene->mMeshes[0];
+
+		vertices.reserve(mesh->mNumVertices);
+		indices.reserve(mesh->mNumFaces * 3);
+
+		//Loop through all the vertices to get the vertex data
+		for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+		{
+			//Vertex container 
+			Vertex vertex;
+
+			//Vertex data
+			glm::vec3 position;
+			glm::vec3 normal;
+			glm::vec2 textureCoordinate;
+
+			//Temp container for holding the vertex data
+			glm::vec3 vec3Container;
+
+			//Vertices of the model
+			vec3Container.x = mesh->mVertices[i].x;
+			vec3Container.y = mesh->mVertices[i].y;
+			vec3Container.z = mesh->mVertices[i].z;
+			position = vec3Container;
+
+			//Normals of the model
+			vec3Container.x = mesh->mNormals[i].x;
+			vec3Container.y = mesh->mNormals[i].y;
+			vec3Container.z = mesh->mNormals[i].z;
+			normal = vec3Container;
+
+			//Texture coordinates of the model if present
+			if (mesh->mTextureCoords[0])
+			{
+				//Temp container for holding the vertex data
+				glm::vec2 vec2Container;
+
+				//Texture coordinates of the model
+				vec2Container.x = mesh->mTextureCoords[0][i].x;
+				vec2Container.y = mesh->mTextureCoords[0][i].y;
+				textureCoordinate = vec2Container;
+			}
+
+			//Set texture coordinates to 0 if not present
+			else textureCoordinate = glm::vec2(0.0f, 0.0f);
+
+			//Assign the vertex data
+			vertex.Position = position;
+			vertex.Normal = normal;
+			vertex.TexCoords = textureCoordinate;
+
+			//Push back the complete vertex to the vertices array
+			vertices.push_back(vertex);
+		}
+
+		//Loop through all the faces to get the face data
+		for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+		{
+			//Creat a temp face container
+			aiFace face = mesh->mFaces[i];
+
+			//Loop through all the face indices
+			for (unsigned int j = 0; j < face.mNumIndices; j++)
+				indices.push_back(face.mIndices[j]);
+		}
+
+		return !vertices.empty() && !indices.empty();
+	}
+
+	MeshBounds ComputeBounds(const std::vector<Vertex>& vertices)
+	{
+		MeshBounds bounds;
+		bounds.min = vertices[0].Position;
+		bounds.max = vertices[0].Position;
+
+		for (const Vertex& vertex : vertices)
+		{
+			bounds.min = glm::min(bounds.min, vertex.Position);
+			bounds.max = glm::max(bounds.max, vertex.Position);
+		}
+
+		bounds.centre = (bounds.min + bounds.max) * 0.5f;
+
+		for (const Vertex& vertex : vertices)
+		{
+			bounds.radius = glm::max(bounds.radius, glm::distance(bounds.centre, vertex.Position));
+		}
+
+		return bounds;
+	}
+
+	// appends each simplified level to indices, roughly a quarter of the triangles of the one before
+	std::vector<MeshLod> BuildLods(const std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, unsigned lodLevels)
+	{
+		std::vector<MeshLod> lods = { { 0, (unsigned)indices.size(), FLT_MAX } };
+
+		unsigned resolution = 16;
+		float maxScreenSize = firstLodScreenSize;
+
+		for (unsigned level = 0; level < lodLevels; level++)
+		{
+			const MeshLod& finer = lods.back();
+			const std::vector<unsigned> source(indices.begin() + finer.firstIndex, indices.begin() + finer.firstIndex + finer.count);
+
+			// coarsens the grid until the level has at most a quarter of the previous triangles
+			std::vector<unsigned> simplified;
+
+			for (; resolution >= 2; resolution--)
+			{
+				simplified = SimplifyByClustering(vertices, source, resolution);
+
+				if (simplified.size() * 4 <= source.size())
+				{
+					break;
+				}
+			}
+
+			if (simplified.empty() || simplified.size() >= source.size())
+			{
+				break;
+			}
+
+			OptimizeVertexCache(simplified, (unsigned)vertices.size());
+
+			lods.push_back({ (unsigned)indices.size(), (unsigned)simplified.size(), maxScreenSize });
+			indices.insert(indices.end(), simplified.begin(), simplified.end());
+
+			std::cout << "  lod " << lods.size() - 1 << ": " << simplified.size() / 3 << " triangles" << std::endl;
+
+			maxScreenSize *= 0.25f;
+		}
+
+		return lods;
+	}
+
+	// packs the vertices and returns the matrix that undoes the position quantization
+	glm::mat4 Quantize(const std::vector<Vertex>& vertices, std::vector<CompactVertex>& compact)
+	{
+		glm::vec3 boundsMin(vertices[0].Position);
+		glm::vec3 boundsMax(vertices[0].Position);
+
+		for (const Vertex& vertex : vertices)
+		{
+			boundsMin = glm::min(boundsMin, vertex.Position);
+			boundsMax = glm::max(boundsMax, vertex.Position);
+		}
+
+		// one scale for every axis keeps the dequantize matrix uniform, so it doesn't skew the normals
+		const glm::vec3 extent = boundsMax - boundsMin;
+		const float size = glm::max(glm::max(extent.x, extent.y), glm::max(extent.z, 1e-6f));
+
+		compact.reserve(vertices.size());
+
+		for (const Vertex& vertex : vertices)
+		{
+			const glm::vec3 position = (vertex.Position - boundsMin) / size;
+
+			compact.push_back(
+				{
+					glm::packUnorm4x16(glm::vec4(position, 0.0f)),
+					glm::packSnorm3x10_1x2(glm::vec4(glm::normalize(vertex.Normal), 0.0f)),
+					glm::packHalf2x16(vertex.TexCoords)
+				}
+			);
+		}
+
+		return glm::scale(glm::translate(glm::mat4(1.0f), boundsMin), glm::vec3(size));
+	}
+}
+
+bool ImportMesh(const std::string& path, VertexFormat format, unsigned lodLevels, MeshData& mesh)
+{
+	std::vector<Vertex> vertices;
+
+	if (!Import(path, vertices, mesh.indices))
+	{
+		return false;
+	}
+
+	const MeshOptimizeStats stats = OptimizeMesh(vertices, mesh.indices);
+
+	std::cout << "Imported mesh " << path << ": " << stats.verticesBefore << " -> " << stats.verticesAfter
+		<< " vertices, ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter << std::endl;
+
+	mesh.format = format;
+	mesh.bounds = ComputeBounds(vertices);
+	mesh.lods = BuildLods(vertices, mesh.indices, lodLevels);
+
+	if (format == VertexFormat::Compact)
+	{
+		mesh.dequantize = Quantize(vertices, mesh.compactVertices);
+	}
+	else
+	{
+		mesh.vertices = std::move(vertices);
+	}
+
+	return true;
+}
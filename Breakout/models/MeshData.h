@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include "../Vertex.h"
+
+// CPU side of the mesh pipeline, without any GL dependency so the bake tool can share it with MeshCache
+
+enum class VertexFormat
+{
+	// float position, normal and texture coordinates, 32 bytes per vertex
+	Full,
+	// quantized position, packed normal and half texture coordinates, 16 bytes per vertex
+	Compact
+};
+
+// model space bounds, computed at import
+struct MeshBounds
+{
+	glm::vec3 min = glm::vec3(0.0f);
+	glm::vec3 max = glm::vec3(0.0f);
+
+	// sphere about the box centre enclosing every vertex
+	glm::vec3 centre = glm::vec3(0.0f);
+	float radius = 0.0f;
+};
+
+// one level of detail, a range of the shared index buffer drawn while the object covers less than
+// maxScreenSize of half the viewport height
+struct MeshLod
+{
+	unsigned firstIndex;
+	unsigned count;
+	float maxScreenSize;
+};
+
+// everything the GPU buffers of a mesh are built from
+struct MeshData
+{
+	VertexFormat format = VertexFormat::Full;
+
+	// vertices for VertexFormat::Full, compactVertices for VertexFormat::Compact
+	std::vector<Vertex> vertices;
+	std::vector<CompactVertex> compactVertices;
+
+	// the full mesh followed by each simplified level
+	std::vector<unsigned> indices;
+
+	MeshBounds bounds;
+	std::vector<MeshLod> lods;
+
+	// applied before the model matrix, the identity unless the positions are quantized
+	glm::mat4 dequantize = glm::mat4(1.0f);
+};
+
+// imports the first mesh of the file with Assimp, optimizes it, builds lodLevels simplified levels and packs
+// the vertices into the format. Returns false if the import fails
+bool ImportMesh(const std::string& path, VertexFormat format, unsigned lodLevels, MeshData& mesh);
@@ -0,0 +1,333 @@
+#include "MeshOptimizer.h"
+
+#include <cstring>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+namespace
+{
+	// hashes the raw bytes so only exact duplicates are welded
+	struct VertexHash
+	{
+		size_t operator()(const Vertex& vertex) const
+		{
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&vertex);
+			size_t hash = 14695981039346656037ull;
+
+			for (size_t i = 0; i < sizeof(Vertex); i++)
+			{
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+
+			return hash;
+		}
+	};
+
+	struct VertexEqual
+	{
+		bool operator()(const Vertex& a, const Vertex& b) const
+		{
+			return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+		}
+	};
+}
+
+MeshOptimizeStats OptimizeMesh(std::vector<Vertex>& vertices, std::vector<unsigned>& indices)
+{
+	MeshOptimizeStats stats;
+	stats.acmrBefore = ComputeACMR(indices, (unsigned)vertices.size());
+	stats.verticesBefore = (unsigned)vertices.size();
+
+	WeldVertices(vertices, indices);
+	OptimizeVertexCache(indices, (unsigned)vertices.size());
+	OptimizeVertexFetch(vertices, indices);
+
+	stats.acmrAfter = ComputeACMR(indices, (unsigned)vertices.size());
+	stats.verticesAfter = (unsigned)vertices.size();
+
+	return stats;
+}
+
+void WeldVertices(std::vector<Vertex>& vertices, std::vector<unsigned>& indices)
+{
+	std::unordered_map<Vertex, unsigned, VertexHash, VertexEqual> unique;
+	unique.reserve(vertices.size());
+
+	std::vector<unsigned> remap(vertices.size());
+	std::vector<Vertex> welded;
+	welded.reserve(vertices.size());
+
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		const auto inserted = unique.emplace(vertices[i], (unsigned)welded.size());
+
+		if (inserted.second)
+		{
+			welded.push_back(vertices[i]);
+		}
+
+		remap[i] = inserted.first->second;
+	}
+
+	for (unsigned& index : indices)
+	{
+		index = remap[index];
+	}
+
+	vertices = std::move(welded);
+}
+
+void OptimizeVertexCache(std::vector<unsigned>& indices, unsigned vertexCount)
+{
+	const unsigned triangleCount = (unsigned)indices.size() / 3;
+
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	// triangles using each vertex, vertex v owns adjacency[adjacencyStart[v]..adjacencyStart[v + 1]]
+	std::vector<unsigned> adjacencyStart(vertexCount + 1, 0);
+	std::vector<unsigned> adjacency(indices.size());
+
+	for (unsigned index : indices)
+	{
+		adjacencyStart[index + 1]++;
+	}
+
+	for (unsigned v = 0; v < vertexCount; v++)
+	{
+		adjacencyStart[v + 1] += adjacencyStart[v];
+	}
+
+	// triangles still to be emitted around each vertex
+	std::vector<unsigned> live(vertexCount);
+
+	for (unsigned v = 0; v < vertexCount; v++)
+	{
+		live[v] = adjacencyStart[v + 1] - adjacencyStart[v];
+	}
+
+	{
+		std::vector<unsigned> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+
+		for (unsigned t = 0; t < triangleCount; t++)
+		{
+			for (unsigned k = 0; k < 3; k++)
+			{
+				adjacency[fill[indices[t * 3 + k]]++] = t;
+			}
+		}
+	}
+
+	// a vertex is in the cache while time - cacheTime[v] <= vertexCacheSize
+	std::vector<unsigned> cacheTime(vertexCount, 0);
+	unsigned time = vertexCacheSize + 1;
+
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<unsigned> deadEnd;
+	std::vector<unsigned> candidates;
+
+	std::vector<unsigned> output;
+	output.reserve(indices.size());
+
+	unsigned cursor = 0;
+	int fanning = (int)indices[0];
+
+	while (fanning >= 0)
+	{
+		candidates.clear();
+
+		for (unsigned a = adjacencyStart[fanning]; a < adjacencyStart[fanning + 1]; a++)
+		{
+			const unsigned t = adjacency[a];
+
+			if (emitted[t])
+			{
+				continue;
+			}
+
+			for (unsigned k = 0; k < 3; k++)
+			{
+				const unsigned v = indices[t * 3 + k];
+
+				output.push_back(v);
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				live[v]--;
+
+				if (time - cacheTime[v] > vertexCacheSize)
+				{
+					cacheTime[v] = time++;
+				}
+			}
+
+			emitted[t] = true;
+		}
+
+		// prefer the candidate that stays in the cache longest while its remaining triangles are emitted
+		int best = -1;
+		int bestPriority = -1;
+
+		for (unsigned v : candidates)
+		{
+			if (live[v] == 0)
+			{
+				continue;
+			}
+
+			int priority = 0;
+
+			if (time - cacheTime[v] + 2 * live[v] <= vertexCacheSize)
+			{
+				priority = (int)(time - cacheTime[v]);
+			}
+
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				best = (int)v;
+			}
+		}
+
+		// dead end, fall back to recently used vertices and then to a linear scan
+		while (best < 0 && !deadEnd.empty())
+		{
+			const unsigned v = deadEnd.back();
+			deadEnd.pop_back();
+
+			if (live[v] > 0)
+			{
+				best = (int)v;
+			}
+		}
+
+		while (best < 0 && cursor < vertexCount)
+		{
+			if (live[cursor] > 0)
+			{
+				best = (int)cursor;
+			}
+
+			cursor++;
+		}
+
+		fanning = best;
+	}
+
+	indices = std::move(output);
+}
+
+void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned>& indices)
+{
+	const unsigned unused = ~0u;
+
+	std::vector<unsigned> remap(vertices.size(), unused);
+	std::vector<Vertex> ordered;
+	ordered.reserve(vertices.size());
+
+	for (unsigned& index : indices)
+	{
+		if (remap[index] == unused)
+		{
+			remap[index] = (unsigned)ordered.size();
+			ordered.push_back(vertices[index]);
+		}
+
+		index = remap[index];
+	}
+
+	vertices = std::move(ordered);
+}
+
+std::vector<unsigned> SimplifyByClustering(const std::vector<Vertex>& vertices, const std::vector<unsigned>& indices, unsigned resolution)
+{
+	glm::vec3 boundsMin(vertices[0].Position);
+	glm::vec3 boundsMax(vertices[0].Position);
+
+	for (const Vertex& vertex : vertices)
+	{
+		boundsMin = glm::min(boundsMin, vertex.Position);
+		boundsMax = glm::max(boundsMax, vertex.Position);
+	}
+
+	const glm::vec3 cellScale = (float)resolution / glm::max(boundsMax - boundsMin, glm::vec3(1e-6f));
+
+	const auto cellOf = [&](const glm::vec3& position)
+	{
+		const glm::uvec3 cell = glm::min(glm::uvec3((position - boundsMin) * cellScale), glm::uvec3(resolution - 1));
+
+		return (cell.z * resolution + cell.y) * resolution + cell.x;
+	};
+
+	// the average position of each occupied cell
+	std::unordered_map<unsigned, glm::vec4> cellSums;
+
+	for (const Vertex& vertex : vertices)
+	{
+		cellSums[cellOf(vertex.Position)] += glm::vec4(vertex.Position, 1.0f);
+	}
+
+	// the representative of a cell is its vertex nearest the average, so the surface shrinks as little as possible
+	std::unordered_map<unsigned, unsigned> representative;
+	std::vector<float> nearest(vertices.size());
+
+	for (unsigned v = 0; v < vertices.size(); v++)
+	{
+		const unsigned cell = cellOf(vertices[v].Position);
+		const glm::vec4& sum = cellSums[cell];
+		const float distance = glm::distance(vertices[v].Position, glm::vec3(sum) / sum.w);
+
+		const auto inserted = representative.emplace(cell, v);
+
+		if (inserted.second || distance < nearest[inserted.first->second])
+		{
+			inserted.first->second = v;
+		}
+
+		nearest[v] = distance;
+	}
+
+	std::vector<unsigned> simplified;
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		const unsigned a = representative[cellOf(vertices[indices[i]].Position)];
+		const unsigned b = representative[cellOf(vertices[indices[i + 1]].Position)];
+		const unsigned c = representative[cellOf(vertices[indices[i + 2]].Position)];
+
+		if (a != b && b != c && a != c)
+		{
+			simplified.insert(simplified.end(), { a, b, c });
+		}
+	}
+
+	return simplified;
+}
+
+float ComputeACMR(const std::vector<unsigned>& indices, unsigned vertexCount)
+{
+	const unsigned triangleCount = (unsigned)indices.size() / 3;
+
+	if (triangleCount == 0)
+	{
+		return 0.0f;
+	}
+
+	// same timestamp trick as the optimizer, a FIFO entry is evicted after vertexCacheSize misses
+	std::vector<unsigned> cacheTime(vertexCount, 0);
+	unsigned time = vertexCacheSize + 1;
+	unsigned misses = 0;
+
+	for (unsigned index : indices)
+	{
+		if (time - cacheTime[index] > vertexCacheSize)
+		{
+			cacheTime[index] = time++;
+			misses++;
+		}
+	}
+
+	return (float)misses / (float)triangleCount;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+#include "../Vertex.h"
+
+// size of the post-transform cache the triangle order is tuned for and measured against
+const unsigned vertexCacheSize = 16;
+
+// average cache misses per triangle before and after optimizing, 3 is the worst and 0.5 the best for large meshes
+struct MeshOptimizeStats
+{
+	float acmrBefore;
+	float acmrAfter;
+	unsigned verticesBefore;
+	unsigned verticesAfter;
+};
+
+// welds, reorders for the vertex cache and then for vertex fetch, in place
+MeshOptimizeStats OptimizeMesh(std::vector<Vertex>& vertices, std::vector<unsigned>& indices);
+
+// merges bit-identical vertices and remaps the indices onto the survivors
+void WeldVertices(std::vector<Vertex>& vertices, std::vector<unsigned>& indices);
+
+// reorders the triangles for post-transform cache hits (Tipsify, Sander et al. 2007)
+void OptimizeVertexCache(std::vector<unsigned>& indices, unsigned vertexCount);
+
+// reorders the vertices by first use so they are fetched front to back, dropping unused ones
+void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned>& indices);
+
+// Collapses each vertex onto one representative per cell of a resolution^3 grid over the mesh bounds
+// and returns the triangles that are not degenerate afterwards. The vertices themselves are untouched,
+// so the result can share their buffer as a lower level of detail.
+std::vector<unsigned> SimplifyByClustering(const std::vector<Vertex>& vertices, const std::vector<unsigned>& indices, unsigned resolution);
+
+// simulates a FIFO cache of vertexCacheSize entries over the triangle list
+float ComputeACMR(const std::vector<unsigned>& indices, unsigned vertexCount);
@@ -1,27 +1,14 @@
 #pragma once
 
-#include <string>
-#include <vector>
-#include <glad/glad.h>
+#include <memory>
 
-#include "../Vertex.h"
+#include "Mesh.h"
 
 class Model
 {
 public:
-	void loadASSIMP(std::string const& path);
-
 	void render();
 
-	void setBuffers();
-
-	std::vector<Vertex> vertices;
-	std::vector<GLuint> indices;
-
-private:
-	GLuint VBO;
-
-	GLuint VAO;
-
-	GLuint EBO;
-};
\ No newline at end of file
+	// shared with every other model loaded from the same file through the MeshCache
+	std::shared_ptr<Mesh> mesh;
+};
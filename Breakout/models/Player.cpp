@@ -2,12 +2,7 @@
 
 Player::Player()
 {
-	position = { 0.0f, 0.0f, 0.0f };
-	scale = { 1.0f, 1.0f, 0.0f };
 	colour = { 1.0f, 1.0f, 1.0f };
 	
 	rotation = 0.0f;
-	
-	lives = 3;
-	score = 0;
 }
\ No newline at end of file
@@ -6,20 +6,15 @@
 #include "Model.h"
 #include "../Texture.h"
 
+// appearance of the paddle, its position and lives live in the Simulation
 class Player : public Model
 {
 public:
 	Player();
 
-	glm::vec3 position;
-	glm::vec3 scale;
 	glm::vec3 colour;
-	glm::vec2 velocity = {15.0f,0.0f};
 
-	Texture texture;
+	std::shared_ptr<Texture> texture;
 
 	float rotation;
-	
-	int lives;
-	int score;
 };
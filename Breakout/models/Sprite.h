@@ -1,12 +1,13 @@
 #pragma once
 
+#include <memory>
+
 #include <glm/vec3.hpp>
 
-#include "Square.h"
 #include "../Texture.h"
 
+// a HUD quad in screen pixels, drawn through the SpriteBatch
 class Sprite
-	: public Square
 {
 public:
 	Sprite();
@@ -15,7 +16,7 @@ public:
 	glm::vec3 scale;
 	glm::vec3 colour;
 
-	Texture texture;
+	std::shared_ptr<Texture> texture;
 
 	bool active;
 };
@@ -0,0 +1,47 @@
+#include "BallRenderer.h"
+
+// texture array layers
+const unsigned ballLayer = 0;
+const unsigned powerUpLayer = 1;
+
+// the sphere is by far the densest mesh and hundreds of balls are usually only a few pixels wide
+const unsigned ballLodLevels = 2;
+
+const std::vector<std::string> ballFiles =
+{
+	"res\\content\\ball.png",
+	"res\\content\\ball2.png"
+};
+
+// translate * scale, balls do not spin
+static glm::mat4 BallMatrix(const glm::vec3& position, const glm::vec3& scale)
+{
+	return glm::mat4
+	(
+		scale.x, 0.0f, 0.0f, 0.0f,
+		0.0f, scale.y, 0.0f, 0.0f,
+		0.0f, 0.0f, scale.z, 0.0f,
+		position.x, position.y, position.z, 1.0f
+	);
+}
+
+BallRenderer::BallRenderer(MeshCache& meshes, TextureCache& textures, DynamicRingBuffer& ring)
+	: InstancedRenderer(meshes, textures, ring, "res\\mesh\\sphere.obj", ballFiles, ballLodLevels)
+{
+}
+
+void BallRenderer::Submit(const std::vector<BallState>& balls, const glm::vec3& tint)
+{
+	for (const BallState& ball : balls)
+	{
+		instances.push_back({ BallMatrix(ball.position, ball.scale), tint, (float)ballLayer });
+	}
+}
+
+void BallRenderer::Submit(const std::vector<PowerUpState>& powerUps, const glm::vec3& tint)
+{
+	for (const PowerUpState& powerUp : powerUps)
+	{
+		instances.push_back({ BallMatrix(powerUp.position, powerUp.scale), tint, (float)powerUpLayer });
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+
+#include "InstancedRenderer.h"
+#include "../simulation/Simulation.h"
+
+// Draws every ball and falling power-up with the sphere mesh in one instanced call
+class BallRenderer : public InstancedRenderer
+{
+public:
+	BallRenderer(MeshCache& meshes, TextureCache& textures, DynamicRingBuffer& ring);
+
+	using InstancedRenderer::Submit;
+
+	void Submit(const std::vector<BallState>& balls, const glm::vec3& tint);
+	void Submit(const std::vector<PowerUpState>& powerUps, const glm::vec3& tint);
+};
@@ -0,0 +1,50 @@
+#include "BrickRenderer.h"
+
+#include <cmath>
+
+const std::vector<std::string> materialFiles =
+{
+	"res\\content\\blocks\\brick_block.png",
+	"res\\content\\blocks\\cobble_block.png",
+	"res\\content\\blocks\\diamond_block.png",
+	"res\\content\\blocks\\emerald_block.png",
+	"res\\content\\blocks\\gold_block.png",
+	"res\\content\\blocks\\grass_block.png",
+	"res\\content\\blocks\\iron_block.png",
+	"res\\content\\crack.png"
+};
+
+BrickRenderer::BrickRenderer(MeshCache& meshes, TextureCache& textures, DynamicRingBuffer& ring)
+	: InstancedRenderer(meshes, textures, ring, "res\\mesh\\cube.obj", materialFiles)
+{
+}
+
+void BrickRenderer::Submit(const BrickField& bricks)
+{
+	const unsigned count = bricks.GetSize();
+
+	for (unsigned i = 0; i < count; i++)
+	{
+		// a dying brick that has shrunk away would only turn inside out
+		if ((!bricks.alive[i] && !bricks.dying[i]) || bricks.scale[i].x <= 0.0f)
+		{
+			continue;
+		}
+
+		// translate * rotate about y * scale, written out rather than built from three matrix products
+		const glm::vec3& position = bricks.position[i];
+		const glm::vec3& scale = bricks.scale[i];
+		const float c = std::cos(bricks.rotation[i]);
+		const float s = std::sin(bricks.rotation[i]);
+
+		const glm::mat4 model
+		(
+			c * scale.x, 0.0f, -s * scale.x, 0.0f,
+			0.0f, scale.y, 0.0f, 0.0f,
+			s * scale.z, 0.0f, c * scale.z, 0.0f,
+			position.x, position.y, position.z, 1.0f
+		);
+
+		instances.push_back({ model, glm::vec3(1.0f), (float)bricks.material[i] });
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "InstancedRenderer.h"
+#include "../simulation/BrickField.h"
+
+// texture array layers, one per BlockMaterial in the same order
+extern const std::vector<std::string> materialFiles;
+
+// Draws every block with the cube mesh, one texture layer per BlockMaterial
+class BrickRenderer : public InstancedRenderer
+{
+public:
+	BrickRenderer(MeshCache& meshes, TextureCache& textures, DynamicRingBuffer& ring);
+
+	using InstancedRenderer::Submit;
+
+	// every brick still on screen, built straight from the field's arrays
+	void Submit(const BrickField& bricks);
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// binding point of the FrameData uniform block declared by the projection shaders
+const unsigned frameDataBinding = 0;
+
+// CPU mirror of the std140 FrameData block, vec3 values are padded to vec4
+struct FrameData
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec4 lightPosition;
+	glm::vec4 lightColour;
+	glm::vec4 viewPosition;
+};
+
+static_assert(sizeof(FrameData) == 2 * 64 + 3 * 16, "FrameData has to match the std140 layout of the shader block");
@@ -0,0 +1,92 @@
+#include "Frustum.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_SSE
+
+#include <emmintrin.h>
+#endif
+
+glm::vec4 TransformSphere(const glm::mat4& model, const glm::vec3& centre, float radius)
+{
+	const float scale = glm::max(glm::length(glm::vec3(model[0])), glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+
+	return glm::vec4(glm::vec3(model * glm::vec4(centre, 1.0f)), radius * scale);
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+	// glm is column major, so row r is viewProjection[0..3][r]
+	const glm::mat4 rows = glm::transpose(viewProjection);
+
+	planes[0] = rows[3] + rows[0];
+	planes[1] = rows[3] - rows[0];
+	planes[2] = rows[3] + rows[1];
+	planes[3] = rows[3] - rows[1];
+	planes[4] = rows[3] + rows[2];
+	planes[5] = rows[3] - rows[2];
+
+	// unit normals make the plane distance comparable with the radius
+	for (glm::vec4& plane : planes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+}
+
+bool Frustum::IntersectsSphere(const glm::vec3& centre, float radius) const
+{
+	for (const glm::vec4& plane : planes)
+	{
+		if (glm::dot(glm::vec3(plane), centre) + plane.w < -radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Frustum::CullSpheres(const SphereArrays& spheres, uint32_t* mask) const
+{
+	for (unsigned word = 0; word * 32 < spheres.count; word++)
+	{
+		const unsigned last = std::min(spheres.count, word * 32 + 32);
+
+		uint32_t bits = 0;
+		unsigned i = word * 32;
+
+#ifdef FRUSTUM_SSE
+		// four spheres per batch, a lane stays set while the sphere is on the inside of every plane
+		for (; i + 4 <= last; i += 4)
+		{
+			const __m128 x = _mm_loadu_ps(spheres.x + i);
+			const __m128 y = _mm_loadu_ps(spheres.y + i);
+			const __m128 z = _mm_loadu_ps(spheres.z + i);
+			const __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(spheres.radius + i));
+
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+			for (const glm::vec4& plane : planes)
+			{
+				const __m128 distance = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_mul_ps(y, _mm_set1_ps(plane.y))),
+					_mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+			}
+
+			bits |= (uint32_t)_mm_movemask_ps(inside) << (i % 32);
+		}
+#endif
+
+		for (; i < last; i++)
+		{
+			const glm::vec3 centre(spheres.x[i], spheres.y[i], spheres.z[i]);
+
+			bits |= (uint32_t)IntersectsSphere(centre, spheres.radius[i]) << (i % 32);
+		}
+
+		mask[word] = bits;
+	}
+}
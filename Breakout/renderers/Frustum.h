@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// spheres laid out as four parallel arrays, four of them at a time are tested against each plane
+struct SphereArrays
+{
+	const float* x;
+	const float* y;
+	const float* z;
+	const float* radius;
+
+	unsigned count;
+};
+
+// world space sphere (centre, radius) of a model space one.
+// The largest axis scale keeps it enclosing under non-uniform scaling
+glm::vec4 TransformSphere(const glm::mat4& model, const glm::vec3& centre, float radius);
+
+// words needed by CullSpheres for count spheres
+inline unsigned CullMaskWords(unsigned count) { return (count + 31) / 32; }
+
+// The six planes of a view volume, normals pointing inwards
+class Frustum
+{
+public:
+	// extracts the planes from projection * view, giving world space planes (Gribb and Hartmann)
+	explicit Frustum(const glm::mat4& viewProjection);
+
+	// true unless the sphere is entirely outside one of the planes
+	bool IntersectsSphere(const glm::vec3& centre, float radius) const;
+
+	// Sets bit i % 32 of mask[i / 32] when sphere i intersects the frustum, clears it otherwise.
+	// Uses SSE when the target has it.
+	void CullSpheres(const SphereArrays& spheres, uint32_t* mask) const;
+
+	// left, right, bottom, top, near, far, for culling on the GPU
+	const glm::vec4* GetPlanes() const { return planes; }
+
+private:
+	glm::vec4 planes[6];
+};
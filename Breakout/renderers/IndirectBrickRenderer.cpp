@@ -0,0 +1,230 @@
+#include "IndirectBrickRenderer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "../GLStateCache.h"
+#include "BrickRenderer.h"
+
+// storage bindings of the culling shader after the six field arrays
+const unsigned instanceBinding = 6;
+const unsigned commandBinding = 7;
+
+// invocations per work group, local_size_x of the culling shader
+const unsigned cullGroupSize = 64;
+
+const unsigned initialBricks = 128;
+
+// layout of the indirect commands read by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand
+{
+	unsigned count;
+	unsigned instanceCount;
+	unsigned firstIndex;
+	int baseVertex;
+	unsigned baseInstance;
+};
+
+// the culling shader counts the bricks it dropped for being outside the frustum after the commands
+const unsigned culledCountOffset = maxIndirectLods * sizeof(DrawElementsIndirectCommand);
+
+IndirectBrickRenderer::IndirectBrickRenderer(MeshCache& meshes, TextureCache& textures, DynamicRingBuffer& ring, unsigned lodLevels)
+	: ring(ring)
+{
+	shader = std::make_unique<Shader>("res\\instancedProjection.vert.glsl", "res\\instancedProjection.frag.glsl");
+	cullShader = std::make_unique<Shader>("res\\brickCull.comp.glsl");
+
+	mesh = meshes.Load("res\\mesh\\cube.obj", VertexFormat::Compact, std::min(lodLevels, maxIndirectLods - 1));
+
+	shader->use();
+	shader->setFloatMat4("uDequantize", mesh->GetDequantize());
+	shader->unuse();
+
+	instanceBuffer = std::make_unique<StorageBuffer>((int)(initialBricks * sizeof(InstanceData)));
+	commandBuffer = std::make_unique<StorageBuffer>((int)(culledCountOffset + sizeof(unsigned)));
+
+	vao = std::make_unique<VertexArray>();
+	vao->SetVertexBuffer(mesh->GetVAO()->GetVBO());
+	vao->SetIndexBuffer(mesh->GetVAO()->GetIBO());
+
+	// the std430 Instance struct of the culling shader has the same 80 byte layout
+	vao->SetInstanceBuffer(instanceBuffer->GetID(),
+		{
+			{"iModel", Mat4},
+			{"iTint", Float3},
+			{"iLayer", Float}
+		}
+	);
+
+	vao->Unbind();
+
+	layers = textures.LoadArray(materialFiles);
+}
+
+void IndirectBrickRenderer::Begin()
+{
+	fields.clear();
+	submitted = 0;
+}
+
+void IndirectBrickRenderer::Submit(const BrickField& bricks)
+{
+	const unsigned count = bricks.GetSize();
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	const void* arrays[FieldRanges::arrays] =
+	{
+		bricks.position.data(),
+		bricks.scale.data(),
+		bricks.rotation.data(),
+		bricks.material.data(),
+		bricks.alive.data(),
+		bricks.dying.data()
+	};
+
+	const unsigned sizes[FieldRanges::arrays] =
+	{
+		count * (unsigned)sizeof(glm::vec3),
+		count * (unsigned)sizeof(glm::vec3),
+		count * (unsigned)sizeof(float),
+		count * (unsigned)sizeof(unsigned),
+		count,
+		count
+	};
+
+	FieldRanges field;
+	field.count = count;
+
+	for (unsigned i = 0; i < FieldRanges::arrays; i++)
+	{
+		// the flag arrays are read a word at a time, so their ranges are rounded up to whole words
+		field.sizes[i] = (sizes[i] + 3) & ~3u;
+
+		const auto allocation = ring.Allocate(field.sizes[i], ring.GetStorageAlignment());
+
+		if (!allocation.data)
+		{
+			return;
+		}
+
+		memcpy(allocation.data, arrays[i], sizes[i]);
+		field.offsets[i] = allocation.offset;
+	}
+
+	fields.push_back(field);
+	submitted += count;
+}
+
+void IndirectBrickRenderer::Flush(RenderQueue& queue)
+{
+	if (fields.empty())
+	{
+		return;
+	}
+
+	DrawItem item;
+	item.shader = shader.get();
+	item.vao = vao.get();
+	item.textureTarget = GL_TEXTURE_2D_ARRAY;
+	item.texture = layers->GetTexture();
+	item.indexType = vao->GetIBO()->GetType();
+	item.indirectBuffer = commandBuffer->GetID();
+	item.indirectOffset = 0;
+	item.drawCount = (unsigned)mesh->GetLods().size();
+
+	queue.Submit(item, OpaquePass);
+}
+
+void IndirectBrickRenderer::Dispatch(const Frustum& frustum, float lodScale)
+{
+	if (fields.empty())
+	{
+		return;
+	}
+
+	const std::vector<MeshLod>& lods = mesh->GetLods();
+	const unsigned lodCount = (unsigned)lods.size();
+
+	// every level gets room for every brick, the shader fills each range from its start
+	instanceBuffer->Reserve((int)(lodCount * submitted * sizeof(InstanceData)));
+
+	DrawElementsIndirectCommand commands[maxIndirectLods] = {};
+	float maxScreenSizes[maxIndirectLods] = {};
+
+	for (unsigned lod = 0; lod < lodCount; lod++)
+	{
+		commands[lod] = { lods[lod].count, 0, lods[lod].firstIndex, 0, lod * submitted };
+		maxScreenSizes[lod] = lods[lod].maxScreenSize;
+	}
+
+	const unsigned culled = 0;
+
+	commandBuffer->SetData(commands, (int)(lodCount * sizeof(DrawElementsIndirectCommand)));
+	commandBuffer->SetData(&culled, sizeof(culled), culledCountOffset);
+
+	const MeshBounds& bounds = mesh->GetBounds();
+	const glm::vec4 sphere(bounds.centre, bounds.radius);
+
+	cullShader->use();
+	cullShader->setFloat4Array("uPlanes", frustum.GetPlanes(), 6);
+	cullShader->setFloat4Array("uBounds", &sphere, 1);
+	cullShader->setFloat("uLodScale", lodScale);
+	cullShader->setUint("uLodCount", lodCount);
+	cullShader->setFloatArray("uLodMaxScreenSize", maxScreenSizes, (int)maxIndirectLods);
+
+	instanceBuffer->BindBase(instanceBinding);
+	commandBuffer->BindBase(commandBinding);
+
+	for (size_t i = 0; i < fields.size(); i++)
+	{
+		const FieldRanges& field = fields[i];
+
+		for (unsigned array = 0; array < FieldRanges::arrays; array++)
+		{
+			GLStateCache::BindBufferRange(GL_SHADER_STORAGE_BUFFER, array, ring.GetID(), field.offsets[array], field.sizes[array]);
+		}
+
+		// the previous field's counts have to land before this one adds to them
+		if (i > 0)
+		{
+			glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+		}
+
+		cullShader->setUint("uBrickCount", field.count);
+		glDispatchCompute((field.count + cullGroupSize - 1) / cullGroupSize, 1, 1);
+	}
+
+	// the draw reads the commands and the instances the shader wrote
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+void IndirectBrickRenderer::ReadCounts(unsigned& visible, unsigned& culled)
+{
+	visible = 0;
+	culled = 0;
+
+	if (fields.empty())
+	{
+		return;
+	}
+
+	const unsigned lodCount = (unsigned)mesh->GetLods().size();
+
+	DrawElementsIndirectCommand commands[maxIndirectLods] = {};
+
+	// the shader's atomic counts have to land before GL reads the buffer back
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	GLStateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer->GetID());
+	glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, lodCount * sizeof(DrawElementsIndirectCommand), commands);
+	glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, culledCountOffset, sizeof(culled), &culled);
+
+	for (unsigned lod = 0; lod < lodCount; lod++)
+	{
+		visible += commands[lod].instanceCount;
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "../Shader.h"
+#include "../TextureCache.h"
+#include "../VertexArray.h"
+#include "../buffers/DynamicRingBuffer.h"
+#include "../buffers/StorageBuffer.h"
+#include "../models/MeshCache.h"
+#include "../simulation/BrickField.h"
+#include "Frustum.h"
+#include "InstancedRenderer.h"
+#include "RenderQueue.h"
+
+// levels of detail the culling shader can choose from, the length of its uLodMaxScreenSize array
+const unsigned maxIndirectLods = 4;
+
+// Draws brick fields without any per-brick work on the CPU. The field's arrays are copied into the ring buffer
+// as they are, a compute shader drops the culled and no longer drawn bricks, writes the instances of the rest
+// and counts them into one DrawElementsIndirectCommand per level of detail, and one glMultiDrawElementsIndirect
+// draws them all. Needs GL 4.3, BrickRenderer is the fallback.
+class IndirectBrickRenderer
+{
+public:
+	IndirectBrickRenderer(MeshCache& meshes, TextureCache& textures, DynamicRingBuffer& ring, unsigned lodLevels = 0);
+
+	void Begin();
+
+	// copies the field's arrays into the frame's region of the ring buffer
+	void Submit(const BrickField& bricks);
+
+	// queues the indirect draw of everything submitted
+	void Flush(RenderQueue& queue);
+
+	// Runs the culling shader over the submitted fields. The shader reads the ring buffer and the frame uniforms,
+	// so call it after the ring buffer's Commit and before the queue's Flush.
+	void Dispatch(const Frustum& frustum, float lodScale);
+
+	// bricks handed to the GPU, how many of them survive culling is only known there
+	unsigned GetSubmittedCount() const { return submitted; }
+
+	// Reads back how many bricks the last Dispatch drew and how many it dropped for being outside the frustum.
+	// Waits for the GPU to finish the dispatch, so it is for diagnostics and not for every frame
+	void ReadCounts(unsigned& visible, unsigned& culled);
+
+private:
+	// where Submit put one field's arrays in the ring buffer, in the order of the shader's storage bindings
+	struct FieldRanges
+	{
+		static const unsigned arrays = 6;
+
+		unsigned count;
+		unsigned offsets[arrays];
+		unsigned sizes[arrays];
+	};
+
+	std::unique_ptr<Shader> shader;
+	std::unique_ptr<Shader> cullShader;
+	DynamicRingBuffer& ring;
+
+	std::shared_ptr<Mesh> mesh;
+	std::unique_ptr<VertexArray> vao;
+
+	std::shared_ptr<TextureArray> layers;
+
+	// written by the culling shader only, the instances of level l start at l * submitted
+	std::unique_ptr<StorageBuffer> instanceBuffer;
+	std::unique_ptr<StorageBuffer> commandBuffer;
+
+	std::vector<FieldRanges> fields;
+	unsigned submitted = 0;
+};
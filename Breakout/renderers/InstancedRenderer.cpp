@@ -0,0 +1,163 @@
+#include "InstancedRenderer.h"
+
+#include <bit>
+
+const unsigned initialInstances = 128;
+
+InstancedRenderer::InstancedRenderer(MeshCache& meshes, TextureCache& textures, DynamicRingBuffer& ring, const std::string& meshPath, const std::vector<std::string>& layerFiles, unsigned lodLevels)
+	: ring(ring)
+{
+	shader = std::make_unique<Shader>("res\\instancedProjection.vert.glsl", "res\\instancedProjection.frag.glsl");
+
+	// instanced meshes are small and drawn many times, so they use the 16 byte vertex
+	mesh = meshes.Load(meshPath, VertexFormat::Compact, lodLevels);
+
+	shader->use();
+	shader->setFloatMat4("uDequantize", mesh->GetDequantize());
+	shader->unuse();
+
+	vao = std::make_unique<VertexArray>();
+	vao->SetVertexBuffer(mesh->GetVAO()->GetVBO());
+	vao->SetIndexBuffer(mesh->GetVAO()->GetIBO());
+
+	vao->SetInstanceBuffer(ring.GetID(),
+		{
+			{"iModel", Mat4},
+			{"iTint", Float3},
+			{"iLayer", Float}
+		}
+	);
+
+	vao->Unbind();
+
+	layers = textures.LoadArray(layerFiles);
+
+	instances.reserve(initialInstances);
+}
+
+void InstancedRenderer::Begin()
+{
+	instances.clear();
+	instanceLods.clear();
+	culled = 0;
+}
+
+void InstancedRenderer::Submit(const glm::mat4& model, const glm::vec3& tint, unsigned layer)
+{
+	instances.push_back({ model, tint, (float)layer });
+}
+
+void InstancedRenderer::Cull(const Frustum& frustum, const glm::vec3& viewPosition, float lodScale)
+{
+	const unsigned count = (unsigned)instances.size();
+	const MeshBounds& bounds = mesh->GetBounds();
+
+	sphereX.resize(count);
+	sphereY.resize(count);
+	sphereZ.resize(count);
+	sphereRadius.resize(count);
+	visibleMask.resize(CullMaskWords(count));
+
+	for (unsigned i = 0; i < count; i++)
+	{
+		const glm::vec4 sphere = TransformSphere(instances[i].model, bounds.centre, bounds.radius);
+
+		sphereX[i] = sphere.x;
+		sphereY[i] = sphere.y;
+		sphereZ[i] = sphere.z;
+		sphereRadius[i] = sphere.w;
+	}
+
+	frustum.CullSpheres({ sphereX.data(), sphereY.data(), sphereZ.data(), sphereRadius.data(), count }, visibleMask.data());
+
+	// compacts the visible instances to the front, keeping their order
+	unsigned visible = 0;
+	instanceLods.resize(count);
+
+	for (unsigned word = 0; word < visibleMask.size(); word++)
+	{
+		for (uint32_t bits = visibleMask[word]; bits; bits &= bits - 1)
+		{
+			const unsigned i = word * 32 + std::countr_zero(bits);
+
+			const glm::vec3 centre(sphereX[i], sphereY[i], sphereZ[i]);
+			const float screenSize = sphereRadius[i] * lodScale / glm::max(glm::distance(centre, viewPosition), 1e-3f);
+
+			instanceLods[visible] = (unsigned char)mesh->SelectLod(screenSize);
+			instances[visible++] = instances[i];
+		}
+	}
+
+	culled += count - visible;
+	instances.resize(visible);
+	instanceLods.resize(visible);
+}
+
+void InstancedRenderer::Flush(RenderQueue& queue)
+{
+	if (instances.empty())
+	{
+		return;
+	}
+
+	const std::vector<MeshLod>& lods = mesh->GetLods();
+
+	// instances that were never culled all draw the full mesh
+	instanceLods.resize(instances.size(), 0);
+
+	// counting sort by level, each level's instances then form one range of the instance buffer
+	std::vector<unsigned> lodStart(lods.size() + 1, 0);
+
+	for (unsigned char lod : instanceLods)
+	{
+		lodStart[lod + 1]++;
+	}
+
+	for (size_t lod = 0; lod < lods.size(); lod++)
+	{
+		lodStart[lod + 1] += lodStart[lod];
+	}
+
+	// aligned to whole instances, so the allocation's offset is a base instance of the ring buffer
+	const auto allocation = ring.Allocate((unsigned)(instances.size() * sizeof(InstanceData)), sizeof(InstanceData));
+
+	if (!allocation.data)
+	{
+		return;
+	}
+
+	InstanceData* sorted = (InstanceData*)allocation.data;
+	const unsigned firstInstance = allocation.offset / sizeof(InstanceData);
+
+	{
+		std::vector<unsigned> fill(lodStart.begin(), lodStart.end() - 1);
+
+		for (size_t i = 0; i < instances.size(); i++)
+		{
+			sorted[fill[instanceLods[i]]++] = instances[i];
+		}
+	}
+
+	const IndexBuffer& ibo = *vao->GetIBO();
+
+	for (size_t lod = 0; lod < lods.size(); lod++)
+	{
+		if (lodStart[lod + 1] == lodStart[lod])
+		{
+			continue;
+		}
+
+		DrawItem item;
+		item.shader = shader.get();
+		item.vao = vao.get();
+		item.textureTarget = GL_TEXTURE_2D_ARRAY;
+		item.texture = layers->GetTexture();
+		item.count = lods[lod].count;
+		item.indexType = ibo.GetType();
+		item.indexOffset = lods[lod].firstIndex * ibo.GetIndexSize();
+		item.instances = lodStart[lod + 1] - lodStart[lod];
+		item.baseInstance = firstInstance + lodStart[lod];
+
+		queue.Submit(item, OpaquePass);
+	}
+}
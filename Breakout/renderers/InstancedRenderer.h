@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../Shader.h"
+#include "../TextureCache.h"
+#include "../VertexArray.h"
+#include "../buffers/DynamicRingBuffer.h"
+#include "../models/MeshCache.h"
+#include "Frustum.h"
+#include "RenderQueue.h"
+
+// per-instance data read by the instanced projection shader
+struct InstanceData
+{
+	glm::mat4 model;
+	glm::vec3 tint;
+	float layer;
+};
+
+// Collects every object sharing one mesh and draws them with one instanced call,
+// each instance picking its layer of a texture array
+class InstancedRenderer
+{
+public:
+	// lodLevels simplified versions of the mesh are generated for instances that are small on screen
+	// the instances are written into the frame's region of the ring buffer
+	InstancedRenderer(MeshCache& meshes, TextureCache& textures, DynamicRingBuffer& ring, const std::string& meshPath, const std::vector<std::string>& layerFiles, unsigned lodLevels = 0);
+
+	void Begin();
+	void Submit(const glm::mat4& model, const glm::vec3& tint, unsigned layer);
+
+	// drops the instances whose bounding sphere is outside the frustum and picks a level of detail for the rest.
+	// lodScale is projection[1][1], turning radius / distance into a fraction of half the viewport height
+	void Cull(const Frustum& frustum, const glm::vec3& viewPosition, float lodScale);
+
+	// writes the instances grouped by level of detail into the ring buffer and queues one instanced draw per level,
+	// camera and lighting come from the FrameData uniform buffer
+	void Flush(RenderQueue& queue);
+
+	unsigned GetInstanceCount() const { return (unsigned)instances.size(); }
+	unsigned GetCulledCount() const { return culled; }
+
+protected:
+	std::vector<InstanceData> instances;
+
+private:
+	std::unique_ptr<Shader> shader;
+	DynamicRingBuffer& ring;
+
+	// the mesh's buffers come from the mesh cache, only the instance buffer belongs to this vertex array
+	std::shared_ptr<Mesh> mesh;
+	std::unique_ptr<VertexArray> vao;
+
+	std::shared_ptr<TextureArray> layers;
+
+	// world space bounding spheres of the instances, reused between frames
+	std::vector<float> sphereX;
+	std::vector<float> sphereY;
+	std::vector<float> sphereZ;
+	std::vector<float> sphereRadius;
+	std::vector<uint32_t> visibleMask;
+
+	// level of detail of each instance after Cull
+	std::vector<unsigned char> instanceLods;
+
+	unsigned culled = 0;
+};
@@ -0,0 +1,124 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+#include "../GLStateCache.h"
+
+uint64_t RenderQueue::MakeKey(RenderPass pass, unsigned shader, unsigned texture, unsigned mesh, float depth)
+{
+	const uint64_t depthBits = (uint64_t)(glm::clamp(depth, 0.0f, 1.0f) * 0xFFFF);
+
+	return (uint64_t)(pass & 0xF) << 60
+		| (uint64_t)(shader & 0xFFF) << 48
+		| (uint64_t)(texture & 0xFFFF) << 32
+		| (uint64_t)(mesh & 0xFFFF) << 16
+		| depthBits;
+}
+
+void RenderQueue::Begin()
+{
+	items.clear();
+}
+
+void RenderQueue::Submit(DrawItem item, RenderPass pass, float depth)
+{
+	item.key = MakeKey(pass, item.shader->ID, item.texture, item.vao->GetID(), depth);
+
+	items.push_back(item);
+}
+
+void RenderQueue::Flush()
+{
+	stateChanges = 0;
+
+	if (items.empty())
+	{
+		return;
+	}
+
+	order.clear();
+
+	for (unsigned i = 0; i < items.size(); i++)
+	{
+		order.push_back({ items[i].key, i });
+	}
+
+	// stable so items with equal keys keep their submission order
+	std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+	int pass = -1;
+	Shader* shader = nullptr;
+	VertexArray* vao = nullptr;
+	unsigned texture = 0;
+
+	for (const auto& entry : order)
+	{
+		const DrawItem& item = items[entry.second];
+		const int itemPass = (int)(item.key >> 60);
+
+		if (itemPass != pass)
+		{
+			pass = itemPass;
+			ApplyPass((RenderPass)pass);
+			stateChanges++;
+		}
+
+		if (item.shader != shader)
+		{
+			shader = item.shader;
+			shader->use();
+			stateChanges++;
+		}
+
+		if (item.vao != vao)
+		{
+			vao = item.vao;
+			vao->Bind();
+			stateChanges++;
+		}
+
+		if (item.texture != texture)
+		{
+			texture = item.texture;
+			GLStateCache::BindTexture(0, item.textureTarget, texture);
+			stateChanges++;
+		}
+
+		if (item.objectUniforms)
+		{
+			shader->setFloat3("uObjectColour", item.colour);
+			shader->setFloatMat4("uModel", item.model);
+			shader->setFloatMat3("uNormalMatrix", item.normalMatrix);
+		}
+
+		if (item.drawCount > 0)
+		{
+			GLStateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, item.indirectBuffer);
+			glMultiDrawElementsIndirect(GL_TRIANGLES, item.indexType, (void*)item.indirectOffset, item.drawCount, 0);
+		}
+		else if (item.instances == 0)
+		{
+			glDrawElements(GL_TRIANGLES, item.count, item.indexType, (void*)item.indexOffset);
+		}
+		else
+		{
+			glDrawElementsInstancedBaseInstance(GL_TRIANGLES, item.count, item.indexType, (void*)item.indexOffset, item.instances, item.baseInstance);
+		}
+	}
+
+	GLStateCache::BindVertexArray(0);
+}
+
+void RenderQueue::ApplyPass(RenderPass pass)
+{
+	switch (pass)
+	{
+	case OpaquePass:
+		GLStateCache::SetEnabled(GL_DEPTH_TEST, true);
+		break;
+
+	case HudPass:
+		GLStateCache::SetEnabled(GL_DEPTH_TEST, false);
+		break;
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../Shader.h"
+#include "../VertexArray.h"
+
+// passes are drawn in this order, each with its own fixed depth state
+enum RenderPass
+{
+	OpaquePass,
+	HudPass
+};
+
+// one indexed draw, described by the state it needs rather than by the calls that set it
+struct DrawItem
+{
+	uint64_t key = 0;
+
+	Shader* shader = nullptr;
+	VertexArray* vao = nullptr;
+
+	// GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY, bound to unit 0
+	unsigned textureTarget = 0;
+	unsigned texture = 0;
+
+	unsigned count = 0;
+	unsigned indexType = 0;
+	size_t indexOffset = 0;
+
+	// 0 for a plain draw, otherwise an instanced draw of instances baseInstance onwards
+	unsigned instances = 0;
+	unsigned baseInstance = 0;
+
+	// when drawCount is not 0 the draw is glMultiDrawElementsIndirect of drawCount commands
+	// read from indirectBuffer at indirectOffset, count and instances are then ignored
+	unsigned indirectBuffer = 0;
+	size_t indirectOffset = 0;
+	unsigned drawCount = 0;
+
+	// per-object uniforms of the projection shader, only set when objectUniforms is true
+	bool objectUniforms = false;
+	glm::mat4 model = glm::mat4(1.0f);
+	glm::mat3 normalMatrix = glm::mat3(1.0f);
+	glm::vec3 colour = glm::vec3(1.0f);
+};
+
+// Collects the frame's draws, sorts them by key and binds program, vertex array and texture only when they change
+class RenderQueue
+{
+public:
+	// pass | shader | texture | mesh | depth, from the most to the least significant bits.
+	// depth is 0 nearest to 1 furthest, opaque draws sharing state then go front to back
+	static uint64_t MakeKey(RenderPass pass, unsigned shader, unsigned texture, unsigned mesh, float depth);
+
+	void Begin();
+
+	// fills in the key from the item's state, depth and pass
+	void Submit(DrawItem item, RenderPass pass, float depth = 0.0f);
+
+	void Flush();
+
+	unsigned GetDrawCount() const { return (unsigned)items.size(); }
+
+	// program, vertex array, texture and pass changes made by the last Flush
+	unsigned GetStateChanges() const { return stateChanges; }
+
+private:
+	void ApplyPass(RenderPass pass);
+
+	std::vector<DrawItem> items;
+
+	// sorted instead of the items themselves, which are large
+	std::vector<std::pair<uint64_t, unsigned>> order;
+
+	unsigned stateChanges = 0;
+};
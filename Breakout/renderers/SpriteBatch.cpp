@@ -0,0 +1,129 @@
+#include "SpriteBatch.h"
+
+#include <algorithm>
+
+#include <glad/glad.h>
+
+const unsigned initialQuads = 64;
+
+SpriteBatch::SpriteBatch()
+{
+	vao = std::make_unique<VertexArray>();
+
+	auto vertexBuffer = std::make_unique<VertexBuffer>(initialQuads * 4 * sizeof(SpriteVertex));
+
+	vertexBuffer->SetLayout(
+		{
+			{"aPosition", Float2},
+			{"aTexCoord", Float2},
+			{"aColour", Float3}
+		}
+	);
+
+	vao->SetVertexBuffer(std::move(vertexBuffer));
+	vao->Unbind();
+
+	ReserveIndices(initialQuads);
+
+	quads.reserve(initialQuads);
+	vertices.reserve(initialQuads * 4);
+}
+
+void SpriteBatch::Begin()
+{
+	quads.clear();
+}
+
+void SpriteBatch::Submit(const Texture& texture, const glm::vec2& position, const glm::vec2& size, const glm::vec3& colour,
+	const glm::vec2& texCoordMin, const glm::vec2& texCoordMax)
+{
+	// same corners and winding as Square, screen y grows downwards so the bottom of the quad samples the bottom of the image
+	const glm::vec2 max = position + size;
+
+	quads.push_back(
+		{
+			&texture,
+			{
+				{ max, texCoordMax, colour },
+				{ glm::vec2(max.x, position.y), glm::vec2(texCoordMax.x, texCoordMin.y), colour },
+				{ position, texCoordMin, colour },
+				{ glm::vec2(position.x, max.y), glm::vec2(texCoordMin.x, texCoordMax.y), colour }
+			}
+		}
+	);
+}
+
+void SpriteBatch::End()
+{
+	std::stable_sort(quads.begin(), quads.end(), [](const Quad& a, const Quad& b)
+	{
+		return a.texture->GetTexture() < b.texture->GetTexture();
+	});
+
+	vertices.clear();
+	ranges.clear();
+
+	for (unsigned i = 0; i < (unsigned)quads.size(); i++)
+	{
+		vertices.insert(vertices.end(), std::begin(quads[i].vertices), std::end(quads[i].vertices));
+
+		if (ranges.empty() || ranges.back().texture != quads[i].texture)
+		{
+			ranges.push_back({ quads[i].texture, i, 0 });
+		}
+
+		ranges.back().count++;
+	}
+
+	if (vertices.empty())
+	{
+		return;
+	}
+
+	ReserveIndices((unsigned)quads.size());
+
+	vao->GetVBO()->SetData(vertices.data(), (int)(vertices.size() * sizeof(SpriteVertex)));
+}
+
+void SpriteBatch::Draw(RenderQueue& queue, Shader& shader)
+{
+	for (const auto& range : ranges)
+	{
+		DrawItem item;
+		item.shader = &shader;
+		item.vao = vao.get();
+		item.textureTarget = GL_TEXTURE_2D;
+		item.texture = range.texture->GetTexture();
+		item.count = range.count * 6;
+		item.indexType = GL_UNSIGNED_INT;
+		item.indexOffset = range.first * 6 * sizeof(unsigned);
+
+		queue.Submit(item, HudPass);
+	}
+}
+
+void SpriteBatch::ReserveIndices(unsigned quadCount)
+{
+	if (quadCount <= indexCapacity)
+	{
+		return;
+	}
+
+	indexCapacity = std::max(quadCount, indexCapacity * 2);
+
+	// two triangles per quad, the same pattern as Square
+	std::vector<unsigned> indices;
+	indices.reserve(indexCapacity * 6);
+
+	for (unsigned quad = 0; quad < indexCapacity; quad++)
+	{
+		const unsigned first = quad * 4;
+
+		indices.insert(indices.end(), { first, first + 1, first + 3, first + 1, first + 2, first + 3 });
+	}
+
+	// bound first so creating the buffer only touches this vertex array
+	vao->Bind();
+	vao->SetIndexBuffer(std::make_shared<IndexBuffer>(indices.data(), (int)indices.size()));
+	vao->Unbind();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../Texture.h"
+#include "../VertexArray.h"
+#include "RenderQueue.h"
+
+struct SpriteVertex
+{
+	glm::vec2 position;
+	glm::vec2 texCoord;
+	glm::vec3 colour;
+};
+
+// Collects screen space quads into one streaming vertex buffer and draws them with one call per texture.
+// The uploaded quads are kept after End, so while nothing changes a frame only has to call Draw.
+class SpriteBatch
+{
+public:
+	SpriteBatch();
+
+	void Begin();
+
+	// rectangle from position to position + size in screen pixels, texCoordMin/Max pick part of the texture
+	void Submit(const Texture& texture, const glm::vec2& position, const glm::vec2& size, const glm::vec3& colour = glm::vec3(1.0f),
+		const glm::vec2& texCoordMin = glm::vec2(0.0f), const glm::vec2& texCoordMax = glm::vec2(1.0f));
+
+	// groups the quads by texture, keeping submission order within a texture, and uploads them
+	void End();
+
+	// queues one draw per texture in the HUD pass, the shader's view and projection have to be set
+	void Draw(RenderQueue& queue, Shader& shader);
+
+	unsigned GetQuadCount() const { return (unsigned)quads.size(); }
+	unsigned GetDrawCount() const { return (unsigned)ranges.size(); }
+
+private:
+	void ReserveIndices(unsigned quadCount);
+
+	struct Quad
+	{
+		const Texture* texture;
+		SpriteVertex vertices[4];
+	};
+
+	// quads first..first + count share a texture
+	struct DrawRange
+	{
+		const Texture* texture;
+		unsigned first;
+		unsigned count;
+	};
+
+	std::vector<Quad> quads;
+	std::vector<SpriteVertex> vertices;
+	std::vector<DrawRange> ranges;
+
+	std::unique_ptr<VertexArray> vao;
+	unsigned indexCapacity = 0;
+};
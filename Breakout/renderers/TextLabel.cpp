@@ -0,0 +1,59 @@
+#include "TextLabel.h"
+
+TextLabel::TextLabel(const GlyphAtlas& atlas, const glm::vec2& anchor, float height, TextAlign align)
+	: atlas(atlas), anchor(anchor), height(height), align(align)
+{
+}
+
+bool TextLabel::SetText(const std::string& text)
+{
+	if (text == this->text)
+	{
+		return false;
+	}
+
+	this->text = text;
+	Layout();
+
+	return true;
+}
+
+void TextLabel::Submit(SpriteBatch& batch) const
+{
+	for (const auto& quad : quads)
+	{
+		batch.Submit(atlas.GetTexture(), quad.position, quad.size, colour, quad.glyph->texCoordMin, quad.glyph->texCoordMax);
+	}
+}
+
+void TextLabel::Layout()
+{
+	quads.clear();
+
+	float x = 0.0f;
+
+	for (const char character : text)
+	{
+		const Glyph* glyph = atlas.GetGlyph(character);
+
+		// characters missing from the atlas are skipped rather than drawn as garbage
+		if (!glyph)
+		{
+			continue;
+		}
+
+		const glm::vec2 size(height * glyph->aspect, height);
+
+		quads.push_back({ glm::vec2(x, 0.0f), size, glyph });
+		x += size.x + spacing;
+	}
+
+	width = quads.empty() ? 0.0f : x - spacing;
+
+	const glm::vec2 origin = align == TextAlign::Right ? anchor - glm::vec2(width, 0.0f) : anchor;
+
+	for (auto& quad : quads)
+	{
+		quad.position += origin;
+	}
+}
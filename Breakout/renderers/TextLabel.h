@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "SpriteBatch.h"
+#include "../Texture.h"
+
+enum class TextAlign { Left, Right };
+
+// A string laid out as one quad per character from a GlyphAtlas.
+// The quads are only rebuilt when the text changes, submitting an unchanged label just copies them.
+class TextLabel
+{
+public:
+	// anchor is the top left corner for Left and the top right corner for Right, in screen pixels
+	TextLabel(const GlyphAtlas& atlas, const glm::vec2& anchor, float height, TextAlign align = TextAlign::Left);
+
+	// returns false when text is what the label already shows
+	bool SetText(const std::string& text);
+
+	void Submit(SpriteBatch& batch) const;
+
+	const std::string& GetText() const { return text; }
+	float GetWidth() const { return width; }
+
+	glm::vec3 colour = glm::vec3(1.0f);
+
+	// added to every glyph's width when advancing, negative values overlap the glyphs
+	float spacing = 0.0f;
+
+private:
+	void Layout();
+
+	struct GlyphQuad
+	{
+		glm::vec2 position;
+		glm::vec2 size;
+		const Glyph* glyph;
+	};
+
+	const GlyphAtlas& atlas;
+
+	glm::vec2 anchor;
+	float height;
+	TextAlign align;
+
+	std::string text;
+	std::vector<GlyphQuad> quads;
+	float width = 0.0f;
+};
@@ -0,0 +1,124 @@
+#version 460 core
+
+// one invocation per brick, see IndirectBrickRenderer
+layout (local_size_x = 64) in;
+
+struct DrawElementsIndirectCommand
+{
+	uint count;
+	uint instanceCount;
+	uint firstIndex;
+	int baseVertex;
+	uint baseInstance;
+};
+
+// matches InstanceData and the instance attributes of instancedProjection.vert
+struct Instance
+{
+	mat4 model;
+	vec3 tint;
+	float layer;
+};
+
+// the BrickField arrays as they are on the CPU, vec3 arrays are read as three floats per brick
+layout (std430, binding = 0) readonly buffer Positions { float positions[]; };
+layout (std430, binding = 1) readonly buffer Scales { float scales[]; };
+layout (std430, binding = 2) readonly buffer Rotations { float rotations[]; };
+layout (std430, binding = 3) readonly buffer Materials { uint materials[]; };
+
+// one byte per brick, four to a word
+layout (std430, binding = 4) readonly buffer Alive { uint alive[]; };
+layout (std430, binding = 5) readonly buffer Dying { uint dying[]; };
+
+layout (std430, binding = 6) writeonly buffer Instances { Instance instances[]; };
+// one command per level of detail, then the bricks in play that fell outside the frustum
+layout (std430, binding = 7) buffer Commands
+{
+	DrawElementsIndirectCommand commands[4];
+	uint culledCount;
+};
+
+layout (std140, binding = 0) uniform FrameData
+{
+	mat4 uView;
+	mat4 uProjection;
+	vec4 uLightPosition;
+	vec4 uLightColour;
+	vec4 uViewPosition;
+};
+
+uniform uint uBrickCount;
+
+// world space planes, normals pointing inwards
+uniform vec4 uPlanes[6];
+
+// model space bounding sphere of the mesh, centre and radius
+uniform vec4 uBounds;
+
+// levels of detail as in Mesh::SelectLod, lodScale is projection[1][1]
+uniform float uLodScale;
+uniform uint uLodCount;
+uniform float uLodMaxScreenSize[4];
+
+bool byteSet(uint word, uint index)
+{
+	return ((word >> ((index & 3u) * 8u)) & 0xFFu) != 0u;
+}
+
+void main()
+{
+	uint brick = gl_GlobalInvocationID.x;
+
+	if (brick >= uBrickCount)
+	{
+		return;
+	}
+
+	// a dying brick that has shrunk away would only turn inside out
+	bool drawn = byteSet(alive[brick >> 2], brick) || byteSet(dying[brick >> 2], brick);
+	vec3 scale = vec3(scales[brick * 3], scales[brick * 3 + 1], scales[brick * 3 + 2]);
+
+	if (!drawn || scale.x <= 0.0f)
+	{
+		return;
+	}
+
+	vec3 position = vec3(positions[brick * 3], positions[brick * 3 + 1], positions[brick * 3 + 2]);
+	float c = cos(rotations[brick]);
+	float s = sin(rotations[brick]);
+
+	// translate * rotate about y * scale, as BrickRenderer builds it
+	mat4 model = mat4
+	(
+		c * scale.x, 0.0f, -s * scale.x, 0.0f,
+		0.0f, scale.y, 0.0f, 0.0f,
+		s * scale.z, 0.0f, c * scale.z, 0.0f,
+		position, 1.0f
+	);
+
+	// a rotation about y keeps the column lengths, so the largest scale bounds the sphere
+	vec3 centre = vec3(model * vec4(uBounds.xyz, 1.0f));
+	float radius = uBounds.w * max(abs(scale.x), max(abs(scale.y), abs(scale.z)));
+
+	for (int i = 0; i < 6; i++)
+	{
+		if (dot(uPlanes[i].xyz, centre) + uPlanes[i].w < -radius)
+		{
+			atomicAdd(culledCount, 1u);
+			return;
+		}
+	}
+
+	float screenSize = radius * uLodScale / max(distance(centre, uViewPosition.xyz), 1e-3f);
+	uint lod = 0u;
+
+	while (lod + 1u < uLodCount && screenSize < uLodMaxScreenSize[lod + 1u])
+	{
+		lod++;
+	}
+
+	// each level owns a range of the instance buffer starting at its baseInstance
+	uint slot = atomicAdd(commands[lod].instanceCount, 1u);
+
+	instances[commands[lod].baseInstance + slot] = Instance(model, vec3(1.0f), float(materials[brick]));
+}
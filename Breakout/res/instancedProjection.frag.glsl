@@ -0,0 +1,38 @@
+#version 460 core
+out vec4 colourFragment;
+
+in vec2 textureCoordinates;
+in vec3 transposedNormals;
+in vec3 fragmentPosition;
+in vec3 lightColour;
+in vec3 objectColour;
+flat in float layer;
+
+layout (std140, binding = 0) uniform FrameData
+{
+	mat4 uView;
+	mat4 uProjection;
+	vec4 uLightPosition;
+	vec4 uLightColour;
+	vec4 uViewPosition;
+};
+
+uniform sampler2DArray uTexture;
+
+void main()
+{
+    // ambient light component
+    float ambientCoefficient = 0.4f;
+    vec3 ambient = ambientCoefficient * lightColour;
+  	
+    // diffuse light component
+	float diffuseCoefficient = 0.8f;	
+    vec3 normalizedNormal = normalize(transposedNormals);
+    vec3 lightDirection = normalize(uLightPosition.xyz - fragmentPosition);
+    float diffuseMax = max(dot(normalizedNormal, lightDirection), 0.0);
+    vec3 diffuse = diffuseCoefficient * diffuseMax * lightColour;
+
+	// resultant output fragment colour
+	vec3 ambientDiffuseSpecular = (ambient + diffuse) * objectColour;
+    colourFragment =  vec4(ambientDiffuseSpecular, 1.0) * texture(uTexture, vec3(textureCoordinates, layer));
+}
\ No newline at end of file
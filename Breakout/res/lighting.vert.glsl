@@ -4,6 +4,8 @@ layout (location = 1) in vec3 aNorm;
 layout (location = 2) in vec2 aTexCoords;
 
 uniform mat4 model;
+// inverse transpose of model, computed on the CPU
+uniform mat3 normalMatrix;
 uniform mat4 view;
 uniform mat4 projection;
 
@@ -17,6 +19,6 @@ void main()
 
     FragPos = vec3(model * vec4(aPos, 1.0));
 
-    Normal = mat3(transpose(inverse(model))) * aNorm;  
+    Normal = normalMatrix * aNorm;
     TexCoords = aTexCoords;
 }   
\ No newline at end of file
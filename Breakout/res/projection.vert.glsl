@@ -1,18 +1,31 @@
 #version 460 core
 
 layout (location = 0) in vec3 inPosition;
-layout (location = 1) in vec2 inTextureCoordinates;
-layout (location = 2) in vec3 inNormals;
+layout (location = 1) in vec3 inNormals;
+layout (location = 2) in vec2 inTextureCoordinates;
 
 out vec2 textureCoordinates;
 out vec3 transposedNormals;
 out vec3 fragmentPosition;
 out vec3 lightColour;
 
+// per-frame values shared by every object, see FrameData.h
+layout (std140, binding = 0) uniform FrameData
+{
+	mat4 uView;
+	mat4 uProjection;
+	vec4 uLightPosition;
+	vec4 uLightColour;
+	vec4 uViewPosition;
+};
+
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
-uniform vec3 uLightColour;
+
+// inverse transpose of uModel, computed once per object on the CPU.
+// With UNIFORM_SCALE the model matrix itself only changes the normals' length, which the fragment shader normalizes away
+#ifndef UNIFORM_SCALE
+uniform mat3 uNormalMatrix;
+#endif
 
 void main()
 {   
@@ -20,9 +33,13 @@ void main()
 	
 	fragmentPosition = vec3(uModel * vec4(inPosition, 1.0f));
 	
-	transposedNormals = mat3(transpose(inverse(uModel))) * inNormals;  
+#ifdef UNIFORM_SCALE
+	transposedNormals = mat3(uModel) * inNormals;
+#else
+	transposedNormals = uNormalMatrix * inNormals;
+#endif
 	
 	textureCoordinates = inTextureCoordinates;
 	
-	lightColour = uLightColour;
+	lightColour = uLightColour.rgb;
 }
\ No newline at end of file
@@ -1,20 +1,22 @@
 #version 460 core
 
-layout (location = 0) in vec3 Position; //vertex positions
+layout (location = 0) in vec2 Position;	//screen space vertex positions
 layout (location = 1) in vec2 texCoord;	//texture coordinates
+layout (location = 2) in vec3 colour;	//per sprite colour
 
 out vec2 textureCoordinate;
+out vec3 spriteColour;
 
-//Uniform for model, view and projection matrices
-uniform mat4 uModel;
+//Uniform for view and projection matrices, sprites are batched already placed on screen
 uniform mat4 uView;
 uniform mat4 uProjection;
 
 void main()
 {
 	//the clip-space output position of the current vertex
-	gl_Position = uProjection * uView * uModel * vec4(Position, 1.0f);	
+	gl_Position = uProjection * uView * vec4(Position, 0.0f, 1.0f);	
 	
-	//Assign the texCoord to the textureCoordinate to pass to the fragment shader
-	textureCoordinate = vec2(texCoord.x, 1 - texCoord.y);	
-}
\ No newline at end of file
+	//Pass the texture coordinates and colour through to the fragment shader
+	textureCoordinate = texCoord;
+	spriteColour = colour;
+}
@@ -0,0 +1,22 @@
+#include "BallPool.h"
+
+BallPool::BallPool(unsigned capacity) : balls(capacity)
+{
+}
+
+BallState* BallPool::Spawn(const BallState& ball)
+{
+	if (count == balls.size())
+	{
+		return nullptr;
+	}
+
+	balls[count] = ball;
+
+	return &balls[count++];
+}
+
+void BallPool::Despawn(unsigned index)
+{
+	balls[index] = balls[--count];
+}
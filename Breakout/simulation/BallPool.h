@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct BallState
+{
+	glm::vec3 position = { 0.0f, 0.0f, 0.0f };
+	glm::vec3 scale = { 0.1f, 0.1f, 0.1f };
+	glm::vec2 velocity = { 5.5f, 10.0f };
+
+	bool stuckToPaddle = true;
+};
+
+// Fixed capacity store of the balls in play. Live balls stay packed at the front so updates
+// and the instance upload run over one contiguous range, and spawning never allocates.
+class BallPool
+{
+public:
+	explicit BallPool(unsigned capacity);
+
+	// copies ball into the pool, nullptr when the pool is full
+	BallState* Spawn(const BallState& ball);
+
+	// moves the last ball into index, so iterate without advancing after a despawn
+	void Despawn(unsigned index);
+
+	void Clear() { count = 0; }
+
+	unsigned GetCount() const { return count; }
+	unsigned GetCapacity() const { return (unsigned)balls.size(); }
+
+	BallState& operator[](unsigned index) { return balls[index]; }
+	const BallState& operator[](unsigned index) const { return balls[index]; }
+
+	const BallState* begin() const { return balls.data(); }
+	const BallState* end() const { return balls.data() + count; }
+
+private:
+	std::vector<BallState> balls;
+	unsigned count = 0;
+};
@@ -0,0 +1,197 @@
+#include "BatchCollision.h"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BATCH_COLLISION_X86
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_SSE
+#define TARGET_AVX2
+#else
+#define TARGET_SSE __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// bits for boxes first..last of one mask word, used for the whole scalar path and the vector paths' tails
+static inline uint32_t OverlapBits(const glm::vec2& min, const glm::vec2& max, const BoxArrays& boxes, unsigned first, unsigned last)
+{
+	uint32_t bits = 0;
+
+	for (unsigned i = first; i < last; i++)
+	{
+		const bool overlap =
+			boxes.maxX[i] > min.x && boxes.minX[i] < max.x &&
+			boxes.maxY[i] > min.y && boxes.minY[i] < max.y;
+
+		bits |= (uint32_t)overlap << (i % 32);
+	}
+
+	return bits;
+}
+
+static void OverlapBoxesScalar(const glm::vec2& min, const glm::vec2& max, const BoxArrays& boxes, uint32_t* mask)
+{
+	for (unsigned word = 0; word * 32 < boxes.count; word++)
+	{
+		mask[word] = OverlapBits(min, max, boxes, word * 32, std::min(boxes.count, word * 32 + 32));
+	}
+}
+
+#ifdef BATCH_COLLISION_X86
+
+TARGET_SSE static void OverlapBoxesSSE(const glm::vec2& min, const glm::vec2& max, const BoxArrays& boxes, uint32_t* mask)
+{
+	const __m128 minX = _mm_set1_ps(min.x);
+	const __m128 minY = _mm_set1_ps(min.y);
+	const __m128 maxX = _mm_set1_ps(max.x);
+	const __m128 maxY = _mm_set1_ps(max.y);
+
+	for (unsigned word = 0; word * 32 < boxes.count; word++)
+	{
+		const unsigned last = std::min(boxes.count, word * 32 + 32);
+
+		uint32_t bits = 0;
+		unsigned i = word * 32;
+
+		// four boxes per batch
+		for (; i + 4 <= last; i += 4)
+		{
+			const __m128 x = _mm_and_ps(
+				_mm_cmpgt_ps(_mm_loadu_ps(boxes.maxX + i), minX),
+				_mm_cmplt_ps(_mm_loadu_ps(boxes.minX + i), maxX));
+
+			const __m128 y = _mm_and_ps(
+				_mm_cmpgt_ps(_mm_loadu_ps(boxes.maxY + i), minY),
+				_mm_cmplt_ps(_mm_loadu_ps(boxes.minY + i), maxY));
+
+			bits |= (uint32_t)_mm_movemask_ps(_mm_and_ps(x, y)) << (i % 32);
+		}
+
+		mask[word] = bits | OverlapBits(min, max, boxes, i, last);
+	}
+}
+
+TARGET_AVX2 static void OverlapBoxesAVX2(const glm::vec2& min, const glm::vec2& max, const BoxArrays& boxes, uint32_t* mask)
+{
+	const __m256 minX = _mm256_set1_ps(min.x);
+	const __m256 minY = _mm256_set1_ps(min.y);
+	const __m256 maxX = _mm256_set1_ps(max.x);
+	const __m256 maxY = _mm256_set1_ps(max.y);
+
+	for (unsigned word = 0; word * 32 < boxes.count; word++)
+	{
+		const unsigned last = std::min(boxes.count, word * 32 + 32);
+
+		uint32_t bits = 0;
+		unsigned i = word * 32;
+
+		// eight boxes per batch
+		for (; i + 8 <= last; i += 8)
+		{
+			const __m256 x = _mm256_and_ps(
+				_mm256_cmp_ps(_mm256_loadu_ps(boxes.maxX + i), minX, _CMP_GT_OQ),
+				_mm256_cmp_ps(_mm256_loadu_ps(boxes.minX + i), maxX, _CMP_LT_OQ));
+
+			const __m256 y = _mm256_and_ps(
+				_mm256_cmp_ps(_mm256_loadu_ps(boxes.maxY + i), minY, _CMP_GT_OQ),
+				_mm256_cmp_ps(_mm256_loadu_ps(boxes.minY + i), maxY, _CMP_LT_OQ));
+
+			bits |= (uint32_t)_mm256_movemask_ps(_mm256_and_ps(x, y)) << (i % 32);
+		}
+
+		mask[word] = bits | OverlapBits(min, max, boxes, i, last);
+	}
+
+	// leaving the upper halves dirty slows down every SSE instruction the caller runs next
+	_mm256_zeroupper();
+}
+
+static bool HasAVX2()
+{
+#ifdef _MSC_VER
+	int info[4];
+
+	__cpuid(info, 0);
+
+	if (info[0] < 7)
+	{
+		return false;
+	}
+
+	// the OS has to save the ymm registers as well as the CPU supporting them
+	__cpuid(info, 1);
+
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+
+	if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+	{
+		return false;
+	}
+
+	__cpuidex(info, 7, 0);
+
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static bool HasSSE()
+{
+#if defined(_M_X64) || defined(__x86_64__)
+	return true;
+#elif defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+
+	return (info[3] & (1 << 26)) != 0;
+#else
+	return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#endif
+
+std::vector<OverlapPath> AvailableOverlapPaths()
+{
+	std::vector<OverlapPath> paths;
+
+#ifdef BATCH_COLLISION_X86
+	if (HasAVX2())
+	{
+		paths.push_back({ OverlapBoxesAVX2, "avx2" });
+	}
+
+	if (HasSSE())
+	{
+		paths.push_back({ OverlapBoxesSSE, "sse" });
+	}
+#endif
+
+	paths.push_back({ OverlapBoxesScalar, "scalar" });
+
+	return paths;
+}
+
+static const OverlapPath& SelectPath()
+{
+	static const OverlapPath path = AvailableOverlapPaths().front();
+
+	return path;
+}
+
+void OverlapBoxes(const glm::vec2& min, const glm::vec2& max, const BoxArrays& boxes, uint32_t* mask)
+{
+	SelectPath().function(min, max, boxes, mask);
+}
+
+const char* OverlapBoxesPath()
+{
+	return SelectPath().name;
+}
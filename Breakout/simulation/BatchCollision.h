@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// boxes laid out as four parallel arrays so a batch of them loads straight into vector registers
+struct BoxArrays
+{
+	const float* minX;
+	const float* minY;
+	const float* maxX;
+	const float* maxY;
+
+	unsigned count;
+};
+
+// words needed by OverlapBoxes for count boxes
+inline unsigned OverlapMaskWords(unsigned count) { return (count + 31) / 32; }
+
+// Sets bit i % 32 of mask[i / 32] when box i overlaps [min, max], clears it otherwise.
+// Touching edges do not count. Uses AVX2 or SSE when the CPU has them, picked on the first call.
+void OverlapBoxes(const glm::vec2& min, const glm::vec2& max, const BoxArrays& boxes, uint32_t* mask);
+
+// name of the path OverlapBoxes dispatches to: "avx2", "sse" or "scalar"
+const char* OverlapBoxesPath();
+
+using OverlapFunction = void(*)(const glm::vec2&, const glm::vec2&, const BoxArrays&, uint32_t*);
+
+struct OverlapPath
+{
+	OverlapFunction function;
+	const char* name;
+};
+
+// every path this CPU can run, fastest first and always ending with "scalar", so the vector paths can be
+// checked against the portable one
+std::vector<OverlapPath> AvailableOverlapPaths();
@@ -0,0 +1,50 @@
+#include "BrickField.h"
+
+unsigned BrickField::Add(const glm::vec3& position, const glm::vec3& scale, unsigned material)
+{
+	this->position.push_back(position);
+	this->scale.push_back(scale);
+	this->rotation.push_back(0.0f);
+	this->hits.push_back(1);
+	this->alive.push_back(true);
+	this->dying.push_back(false);
+	this->material.push_back(material);
+
+	// bricks collide as squares of their x extent
+	minX.push_back(position.x - scale.x);
+	minY.push_back(position.y - scale.x);
+	maxX.push_back(position.x + scale.x);
+	maxY.push_back(position.y + scale.x);
+
+	return GetSize() - 1;
+}
+
+void BrickField::Clear()
+{
+	position.clear();
+	scale.clear();
+	rotation.clear();
+	hits.clear();
+	alive.clear();
+	dying.clear();
+	material.clear();
+	minX.clear();
+	minY.clear();
+	maxX.clear();
+	maxY.clear();
+}
+
+void BrickField::Reserve(unsigned count)
+{
+	position.reserve(count);
+	scale.reserve(count);
+	rotation.reserve(count);
+	hits.reserve(count);
+	alive.reserve(count);
+	dying.reserve(count);
+	material.reserve(count);
+	minX.reserve(count);
+	minY.reserve(count);
+	maxX.reserve(count);
+	maxY.reserve(count);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+// layers of the block texture array
+enum BlockMaterial
+{
+	BrickBlock,
+	CobbleBlock,
+	DiamondBlock,
+	EmeraldBlock,
+	GoldBlock,
+	GrassBlock,
+	IronBlock,
+	CrackedBlock,
+	BlockMaterialCount
+};
+
+// Every brick of a level stored as parallel arrays, a brick is an index into all of them.
+// Collision, animation and the instance upload each stream only the arrays they read.
+class BrickField
+{
+public:
+	// appends an alive brick and returns its index
+	unsigned Add(const glm::vec3& position, const glm::vec3& scale, unsigned material);
+
+	void Clear();
+	void Reserve(unsigned count);
+
+	unsigned GetSize() const { return (unsigned)position.size(); }
+
+	std::vector<glm::vec3> position;
+	std::vector<glm::vec3> scale;
+	std::vector<float> rotation;
+
+	std::vector<int> hits;
+
+	// bytes rather than vector<bool> so the flags stay addressable and contiguous
+	std::vector<unsigned char> alive;
+	std::vector<unsigned char> dying;
+
+	std::vector<unsigned> material;
+
+	// collision bounds split per axis for the batch overlap kernel, set once by Add as only alive bricks are tested
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+};
@@ -0,0 +1,122 @@
+#include "Collision.h"
+
+#include <cmath>
+#include <utility>
+
+bool SweepCircleBox(const glm::vec2& centre, const glm::vec2& displacement, float radius,
+	const glm::vec2& boxMin, const glm::vec2& boxMax, Contact& contact)
+{
+	const glm::vec2 expandedMin = boxMin - radius;
+	const glm::vec2 expandedMax = boxMax + radius;
+
+	// already overlapping, push out along the axis of least penetration
+	if (centre.x > expandedMin.x && centre.x < expandedMax.x && centre.y > expandedMin.y && centre.y < expandedMax.y)
+	{
+		const float left = centre.x - expandedMin.x;
+		const float right = expandedMax.x - centre.x;
+		const float bottom = centre.y - expandedMin.y;
+		const float top = expandedMax.y - centre.y;
+
+		const float depth = std::fmin(std::fmin(left, right), std::fmin(bottom, top));
+
+		const glm::vec2 normal =
+			depth == left ? glm::vec2(-1.0f, 0.0f) :
+			depth == right ? glm::vec2(1.0f, 0.0f) :
+			depth == bottom ? glm::vec2(0.0f, -1.0f) :
+			glm::vec2(0.0f, 1.0f);
+
+		if (glm::dot(displacement, normal) >= 0.0f)
+		{
+			return false;
+		}
+
+		contact = { 0.0f, normal };
+		return true;
+	}
+
+	// slab test against the box grown by the radius
+	float enter = 0.0f;
+	float exit = 1.0f;
+	glm::vec2 normal(0.0f);
+
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (std::fabs(displacement[axis]) < 1e-8f)
+		{
+			if (centre[axis] < expandedMin[axis] || centre[axis] > expandedMax[axis])
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		float near = (expandedMin[axis] - centre[axis]) / displacement[axis];
+		float far = (expandedMax[axis] - centre[axis]) / displacement[axis];
+
+		if (near > far)
+		{
+			std::swap(near, far);
+		}
+
+		if (near >= enter)
+		{
+			enter = near;
+
+			normal = glm::vec2(0.0f);
+			normal[axis] = displacement[axis] > 0.0f ? -1.0f : 1.0f;
+		}
+
+		exit = std::fmin(exit, far);
+
+		if (enter > exit)
+		{
+			return false;
+		}
+	}
+
+	if (normal == glm::vec2(0.0f))
+	{
+		return false;
+	}
+
+	const glm::vec2 point = centre + displacement * enter;
+
+	// entering through a corner of the grown box, the circle can only touch the corner itself
+	const bool besideX = point.x < boxMin.x || point.x > boxMax.x;
+	const bool besideY = point.y < boxMin.y || point.y > boxMax.y;
+
+	if (besideX && besideY)
+	{
+		const glm::vec2 corner = glm::clamp(point, boxMin, boxMax);
+
+		// solve |centre + t * displacement - corner| = radius for the first t
+		const glm::vec2 offset = centre - corner;
+		const float a = glm::dot(displacement, displacement);
+		const float b = glm::dot(offset, displacement);
+		const float c = glm::dot(offset, offset) - radius * radius;
+		const float discriminant = b * b - a * c;
+
+		if (discriminant < 0.0f)
+		{
+			return false;
+		}
+
+		enter = (-b - std::sqrt(discriminant)) / a;
+
+		if (enter < 0.0f || enter > 1.0f)
+		{
+			return false;
+		}
+
+		normal = glm::normalize(centre + displacement * enter - corner);
+	}
+
+	if (glm::dot(displacement, normal) >= 0.0f)
+	{
+		return false;
+	}
+
+	contact = { enter, normal };
+	return true;
+}
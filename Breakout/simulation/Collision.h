@@ -0,0 +1,15 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// first touch of a moving ball, time is the fraction of the displacement travelled before it
+struct Contact
+{
+	float time;
+	glm::vec2 normal;
+};
+
+// Moving circle against an axis aligned box. Only contacts the circle is moving into are reported,
+// so a ball resting on a face after a bounce is not hit again.
+bool SweepCircleBox(const glm::vec2& centre, const glm::vec2& displacement, float radius,
+	const glm::vec2& boxMin, const glm::vec2& boxMax, Contact& contact);
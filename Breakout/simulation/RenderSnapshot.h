@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+
+#include "BallPool.h"
+#include "BrickField.h"
+#include "Simulation.h"
+
+// What the renderer needs from one simulation step: transforms, materials, HUD values and the game state.
+// Copied out of the simulation so a frame can be drawn while the next steps run.
+struct RenderSnapshot
+{
+	GameState state = GameState::Play;
+	int score = 0;
+	unsigned long long step = 0;
+
+	PaddleState paddle;
+
+	// only the balls in play, not the pool's whole capacity
+	std::vector<BallState> balls;
+	std::vector<PowerUpState> powerUps;
+
+	BrickField bricks;
+};
@@ -0,0 +1,461 @@
+#include "Simulation.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+// playfield limits for the ball and paddle
+const float fieldLeft = -11.0f;
+const float fieldRight = 11.0f;
+const float fieldTop = 9.0f;
+const float fieldBottom = -15.0f;
+
+// area the bricks are laid out in, up to the top of the playfield
+const float fieldWidth = 20.0f;
+const float fieldHeight = 10.0f;
+
+const float paddleLeft = -11.25f;
+const float paddleRight = 11.15f;
+
+// xorshift never leaves zero, so a zero seed falls back to the default
+Simulation::Simulation(uint32_t seed, unsigned bricksWide, unsigned bricksHigh)
+	: seed(seed ? seed : defaultSeed), bricksWide(std::max(1u, bricksWide)), bricksHigh(std::max(1u, bricksHigh)), balls(maxBalls)
+{
+	Reset();
+}
+
+void Simulation::Reset()
+{
+	state = GameState::Play;
+	score = 0;
+	steps = 0;
+
+	paddle = PaddleState();
+
+	balls.Clear();
+	balls.Spawn(BallState());
+
+	powerUps.clear();
+	randomState = seed;
+
+	BuildLevel();
+}
+
+void Simulation::BuildLevel()
+{
+	bricks.Clear();
+	bricks.Reserve(bricksHigh * bricksWide);
+
+	// slots two units apart, closer when that many do not fit between the walls and below the top
+	const float pitch = std::min(2.0f, std::min(fieldWidth / bricksWide, fieldHeight / bricksHigh));
+	const float left = -0.5f * pitch * (bricksWide - 1);
+	const float bottom = fieldTop - fieldHeight + 0.5f * pitch;
+
+	for (unsigned y = 0; y < bricksHigh; y++)
+	{
+		// the default five rows get one material each, taller fields share them out in bands
+		const unsigned band = y * defaultBricksHigh / bricksHigh;
+
+		const unsigned material = 
+			band == 0 ? GrassBlock :
+			band == 1 ? CobbleBlock :
+			band == 2 ? IronBlock :
+			band == 3 ? GoldBlock :
+			band == 4 ? DiamondBlock :
+			EmeraldBlock;
+
+		for (unsigned x = 0; x < bricksWide; x++)
+		{
+			bricks.Add(glm::vec3(left + pitch * x, bottom + pitch * y, 0.0f), glm::vec3(0.25f * pitch), material);
+		}
+	}
+
+	if (bricks.GetSize() > batchScanLimit)
+	{
+		grid.Build(bricks, pitch * gridCellBricks);
+	}
+
+	powerUps.reserve(bricks.GetSize());
+}
+
+void Simulation::Step(const SimulationInput& input)
+{
+	steps++;
+
+	UpdateBricks();
+
+	if (state != GameState::Play)
+	{
+		return;
+	}
+
+	if (IsLevelCleared())
+	{
+		state = GameState::Win;
+		return;
+	}
+
+	UpdatePaddle(input);
+
+	UpdateBalls();
+
+	UpdatePowerUps();
+}
+
+void Simulation::UpdatePaddle(const SimulationInput& input)
+{
+
+	if (paddle.lives <= 0)
+	{
+		state = GameState::Lose;
+		return;
+	}
+
+	const float offset = paddle.scale.x;
+
+	if (input.left && paddle.position.x > paddleLeft + offset)
+	{
+		paddle.position.x -= paddle.velocity.x * timeStep;
+	}
+
+	if (input.right && paddle.position.x < paddleRight - offset)
+	{
+		paddle.position.x += paddle.velocity.x * timeStep;
+	}
+
+	for (unsigned i = 0; i < balls.GetCount(); i++)
+	{
+		BallState& ball = balls[i];
+
+		if (!ball.stuckToPaddle)
+		{
+			continue;
+		}
+
+		if (input.launch)
+		{
+			ball.stuckToPaddle = false;
+		}
+
+		ball.position = glm::vec3
+		(
+			paddle.position.x,
+			paddle.position.y + paddle.scale.y + (ball.scale.y * 2),
+			paddle.position.z
+		);
+	}
+}
+
+void Simulation::UpdateBalls()
+{
+	for (unsigned i = 0; i < balls.GetCount();)
+	{
+		UpdateBall(balls[i]);
+
+		if (balls[i].position.y <= fieldBottom)
+		{
+			balls.Despawn(i);
+			continue;
+		}
+
+		i++;
+	}
+
+	// a life is only lost with the last ball, play resumes with a new one on the paddle
+	if (balls.GetCount() == 0)
+	{
+		paddle.lives--;
+		balls.Spawn(BallState());
+	}
+}
+
+void Simulation::UpdateBall(BallState& ball)
+{
+	if (ball.stuckToPaddle)
+	{
+		return;
+	}
+
+	const float radius = ball.scale.x;
+
+	glm::vec2 position(ball.position);
+	glm::vec2 velocity = ball.velocity;
+
+	// any path of this length stays inside the box, whichever way the ball bounces
+	const float reach = radius + glm::length(velocity) * timeStep;
+	FindNearbyBricks(position - reach, position + reach);
+
+	float remaining = timeStep;
+
+	for (unsigned bounce = 0; bounce < maxBounces && remaining > 0.0f; bounce++)
+	{
+		const glm::vec2 displacement = velocity * remaining;
+
+		Contact nearest = { 2.0f, glm::vec2(0.0f) };
+		int hitBrick = -1;
+		bool hitPaddle = false;
+
+		Contact contact;
+
+		if (SweepWalls(position, displacement, contact) && contact.time < nearest.time)
+		{
+			nearest = contact;
+		}
+
+		const glm::vec2 paddleExtent(paddle.scale);
+
+		if (SweepCircleBox(position, displacement, radius, glm::vec2(paddle.position) - paddleExtent,
+			glm::vec2(paddle.position) + paddleExtent, contact) && contact.time < nearest.time)
+		{
+			nearest = contact;
+			hitPaddle = true;
+		}
+
+		for (const unsigned index : nearbyBricks)
+		{
+			if (!bricks.alive[index])
+			{
+				continue;
+			}
+
+			const glm::vec2 centre(bricks.position[index]);
+			const glm::vec2 brickExtent(bricks.scale[index].x);
+
+			if (SweepCircleBox(position, displacement, radius, centre - brickExtent, centre + brickExtent, contact)
+				&& contact.time < nearest.time)
+			{
+				nearest = contact;
+				hitBrick = (int)index;
+				hitPaddle = false;
+			}
+		}
+
+		if (nearest.time > 1.0f)
+		{
+			position += displacement;
+			break;
+		}
+
+		position += displacement * nearest.time;
+		velocity = glm::reflect(velocity, nearest.normal);
+
+		if (hitPaddle)
+		{
+			velocity.y = std::abs(velocity.y);
+		}
+
+		if (hitBrick >= 0)
+		{
+			SetCrackedBrick((unsigned)hitBrick);
+		}
+
+		remaining *= 1.0f - nearest.time;
+	}
+
+	ball.position.x = position.x;
+	ball.position.y = position.y;
+	ball.velocity = velocity;
+}
+
+void Simulation::UpdatePowerUps()
+{
+	for (unsigned i = 0; i < (unsigned)powerUps.size();)
+	{
+		PowerUpState& powerUp = powerUps[i];
+
+		powerUp.position += glm::vec3(powerUp.velocity * timeStep, 0.0f);
+
+		const bool caught =
+			std::abs(powerUp.position.x - paddle.position.x) < powerUp.scale.x + paddle.scale.x &&
+			std::abs(powerUp.position.y - paddle.position.y) < powerUp.scale.y + paddle.scale.y;
+
+		if (caught)
+		{
+			SplitBalls();
+		}
+
+		if (caught || powerUp.position.y < fieldBottom)
+		{
+			powerUp = powerUps.back();
+			powerUps.pop_back();
+			continue;
+		}
+
+		i++;
+	}
+}
+
+void Simulation::SplitBalls()
+{
+	// only the balls in play before the split, the new ones are appended after them
+	const unsigned count = balls.GetCount();
+
+	for (unsigned i = 0; i < count; i++)
+	{
+		if (balls[i].stuckToPaddle)
+		{
+			continue;
+		}
+
+		for (unsigned split = 1; split < splitBalls; split++)
+		{
+			// fan the copies out to alternating sides of the original direction
+			const float angle = (split % 2 ? 0.35f : -0.35f) * ((split + 1) / 2);
+			const float c = std::cos(angle);
+			const float s = std::sin(angle);
+
+			BallState copy = balls[i];
+			copy.velocity = glm::vec2(c * copy.velocity.x - s * copy.velocity.y, s * copy.velocity.x + c * copy.velocity.y);
+
+			if (!balls.Spawn(copy))
+			{
+				return;
+			}
+		}
+	}
+}
+
+void Simulation::FindNearbyBricks(const glm::vec2& min, const glm::vec2& max)
+{
+	// large fields run the kernel over the boxes of the grid cells the query touches
+	if (bricks.GetSize() > batchScanLimit)
+	{
+		grid.Query(min, max, nearbyBricks);
+		return;
+	}
+
+	const BoxArrays boxes =
+	{
+		bricks.minX.data(),
+		bricks.minY.data(),
+		bricks.maxX.data(),
+		bricks.maxY.data(),
+		bricks.GetSize()
+	};
+
+	overlapMask.resize(OverlapMaskWords(boxes.count));
+	OverlapBoxes(min, max, boxes, overlapMask.data());
+
+	// set bits in ascending order, the same order the grid reports
+	nearbyBricks.clear();
+
+	for (unsigned word = 0; word < (unsigned)overlapMask.size(); word++)
+	{
+		for (uint32_t bits = overlapMask[word]; bits != 0; bits &= bits - 1)
+		{
+			nearbyBricks.push_back(word * 32 + std::countr_zero(bits));
+		}
+	}
+}
+
+bool Simulation::SweepWalls(const glm::vec2& position, const glm::vec2& displacement, Contact& contact)
+{
+	// the walls bound the ball centre, so each is a plane crossing
+	contact.time = 2.0f;
+
+	if (displacement.x < 0.0f && position.x + displacement.x <= fieldLeft)
+	{
+		contact = { std::max(0.0f, (fieldLeft - position.x) / displacement.x), glm::vec2(1.0f, 0.0f) };
+	}
+	else if (displacement.x > 0.0f && position.x + displacement.x >= fieldRight)
+	{
+		contact = { std::max(0.0f, (fieldRight - position.x) / displacement.x), glm::vec2(-1.0f, 0.0f) };
+	}
+
+	if (displacement.y > 0.0f && position.y + displacement.y >= fieldTop)
+	{
+		const float time = std::max(0.0f, (fieldTop - position.y) / displacement.y);
+
+		if (time < contact.time)
+		{
+			contact = { time, glm::vec2(0.0f, -1.0f) };
+		}
+	}
+
+	return contact.time <= 1.0f;
+}
+
+void Simulation::UpdateBricks()
+{
+	const unsigned count = bricks.GetSize();
+
+	for (unsigned i = 0; i < count; i++)
+	{
+		if (bricks.alive[i])
+		{
+			bricks.rotation[i] += timeStep;
+
+			if (bricks.hits[i] < 0)
+			{
+				SetDeadBrick(i);
+			}
+		}
+
+		if (bricks.dying[i])
+		{
+			SetDyingBrick(i);
+		}
+	}
+}
+
+bool Simulation::IsLevelCleared() const
+{
+	return std::none_of(bricks.alive.begin(), bricks.alive.end(), [](unsigned char alive) { return alive; });
+}
+
+void Simulation::SetCrackedBrick(unsigned brick)
+{
+	// already broken by another ball this step, it still deflects but scores nothing
+	if (bricks.hits[brick] < 0)
+	{
+		return;
+	}
+
+	bricks.hits[brick] -= 1;
+	bricks.material[brick] = CrackedBlock;
+
+	score += 1;
+}
+
+void Simulation::SetDeadBrick(unsigned brick)
+{
+	bricks.dying[brick] = true;
+	bricks.alive[brick] = false;
+
+	score += 3;
+
+	if (NextRandom() < powerUpChance)
+	{
+		PowerUpState powerUp;
+		powerUp.position = bricks.position[brick];
+
+		powerUps.push_back(powerUp);
+	}
+}
+
+void Simulation::SetDyingBrick(unsigned brick)
+{
+	// fall, spin and shrink until the brick leaves the playfield
+	bricks.position[brick].y -= 9.5f * timeStep;
+	bricks.rotation[brick] += 4.5f * timeStep;
+
+	if (bricks.scale[brick].x > 0.0f)
+	{
+		bricks.scale[brick] -= 0.75f * timeStep;
+	}
+
+	if (bricks.position[brick].y < fieldBottom)
+	{
+		bricks.dying[brick] = false;
+	}
+}
+
+float Simulation::NextRandom()
+{
+	// xorshift32
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+
+	return (randomState >> 8) * (1.0f / 16777216.0f);
+}
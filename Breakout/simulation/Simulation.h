@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "BallPool.h"
+#include "BatchCollision.h"
+#include "BrickField.h"
+#include "Collision.h"
+#include "SpatialGrid.h"
+
+enum class GameState { Play, Win, Lose, Exit };
+
+// keys held during a step
+struct SimulationInput
+{
+	bool left = false;
+	bool right = false;
+	bool launch = false;
+};
+
+struct PaddleState
+{
+	glm::vec3 position = { 0.0f, -9.5f, 0.0f };
+	glm::vec3 scale = { 1.5f, 0.125f, 0.5f };
+	glm::vec2 velocity = { 15.0f, 0.0f };
+
+	int lives = 3;
+};
+
+// dropped by a breaking brick, catching it with the paddle splits every ball in play
+struct PowerUpState
+{
+	glm::vec3 position = { 0.0f, 0.0f, 0.0f };
+	glm::vec3 scale = { 0.25f, 0.25f, 0.25f };
+	glm::vec2 velocity = { 0.0f, -4.0f };
+};
+
+// The game rules advanced in fixed steps with no window or GL dependency.
+// Matches can run headless, and the renderer only reads the resulting state.
+class Simulation
+{
+public:
+	// seconds advanced by every Step
+	static constexpr float timeStep = 1.0f / 120.0f;
+
+	static constexpr unsigned defaultBricksWide = 10;
+	static constexpr unsigned defaultBricksHigh = 5;
+
+	// contacts resolved for the ball within one step, any time left after the last is dropped
+	static constexpr unsigned maxBounces = 4;
+
+	// balls in play at once, splits beyond this are dropped
+	static constexpr unsigned maxBalls = 1024;
+
+	// chance a breaking brick drops a multiball power-up, and the balls each ball splits into
+	static constexpr float powerUpChance = 0.2f;
+	static constexpr unsigned splitBalls = 3;
+
+	// fields up to this size are scanned whole by the batch overlap kernel instead of walking the grid
+	static constexpr unsigned batchScanLimit = 256;
+
+	// brick slots along each side of a grid cell on larger fields, so one cell is one batch for the kernel
+	static constexpr unsigned gridCellBricks = 8;
+
+	// seeds the power-up drops, the same seed and inputs always play out the same match
+	static constexpr uint32_t defaultSeed = 0x9E3779B9u;
+
+	// the field is bricksWide by bricksHigh bricks, shrunk to fit the playfield when it is bigger than the default
+	explicit Simulation(uint32_t seed = defaultSeed, unsigned bricksWide = defaultBricksWide, unsigned bricksHigh = defaultBricksHigh);
+
+	// rebuilds the level and restores lives, score and the random sequence
+	void Reset();
+
+	void Step(const SimulationInput& input);
+
+	GameState GetState() const { return state; }
+	int GetScore() const { return score; }
+	unsigned long long GetStepCount() const { return steps; }
+
+	const PaddleState& GetPaddle() const { return paddle; }
+	const BallPool& GetBalls() const { return balls; }
+	const std::vector<PowerUpState>& GetPowerUps() const { return powerUps; }
+
+	// row major, GetBricksWide per row
+	const BrickField& GetBricks() const { return bricks; }
+
+	unsigned GetBricksWide() const { return bricksWide; }
+	unsigned GetBricksHigh() const { return bricksHigh; }
+
+private:
+	void BuildLevel();
+
+	void UpdatePaddle(const SimulationInput& input);
+	void UpdateBalls();
+	void UpdateBall(BallState& ball);
+	void UpdatePowerUps();
+	void SplitBalls();
+
+	void FindNearbyBricks(const glm::vec2& min, const glm::vec2& max);
+	void UpdateBricks();
+
+	bool IsLevelCleared() const;
+
+	static bool SweepWalls(const glm::vec2& position, const glm::vec2& displacement, Contact& contact);
+
+	void SetCrackedBrick(unsigned brick);
+	void SetDeadBrick(unsigned brick);
+	void SetDyingBrick(unsigned brick);
+
+	// deterministic so headless matches replay exactly, in [0, 1)
+	float NextRandom();
+
+	uint32_t seed;
+	unsigned bricksWide;
+	unsigned bricksHigh;
+
+	GameState state;
+	int score;
+	unsigned long long steps;
+
+	PaddleState paddle;
+	BallPool balls;
+
+	// at most one per brick, reserved with the level so a drop never allocates
+	std::vector<PowerUpState> powerUps;
+	uint32_t randomState;
+
+	BrickField bricks;
+
+	// broad-phase over the brick field and the bricks it returned for the current ball
+	SpatialGrid grid;
+	std::vector<unsigned> nearbyBricks;
+	std::vector<uint32_t> overlapMask;
+};
@@ -0,0 +1,109 @@
+#include "SimulationThread.h"
+
+#include <chrono>
+
+const unsigned leftBit = 1;
+const unsigned rightBit = 2;
+const unsigned launchBit = 4;
+
+SimulationThread::SimulationThread()
+{
+	// the renderer has a level to draw before the first step
+	Publish();
+}
+
+SimulationThread::~SimulationThread()
+{
+	Stop();
+}
+
+void SimulationThread::Start()
+{
+	if (running.exchange(true))
+	{
+		return;
+	}
+
+	thread = std::thread(&SimulationThread::Run, this);
+}
+
+void SimulationThread::Stop()
+{
+	running = false;
+
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+}
+
+void SimulationThread::SetInput(const SimulationInput& input)
+{
+	this->input.store((input.left ? leftBit : 0) | (input.right ? rightBit : 0) | (input.launch ? launchBit : 0), std::memory_order_relaxed);
+}
+
+const RenderSnapshot& SimulationThread::GetLatest()
+{
+	snapshots.Update();
+
+	return snapshots.GetReadBuffer();
+}
+
+void SimulationThread::Run()
+{
+	using Clock = std::chrono::steady_clock;
+
+	const auto timeStep = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(Simulation::timeStep));
+
+	auto nextStep = Clock::now();
+
+	while (running)
+	{
+		const auto now = Clock::now();
+		unsigned steps = 0;
+
+		// sleeps can overshoot by more than a step, so catch up on every step that is due
+		while (nextStep <= now && steps < maxCatchUpSteps)
+		{
+			const unsigned keys = input.load(std::memory_order_relaxed);
+
+			SimulationInput stepInput;
+			stepInput.left = (keys & leftBit) != 0;
+			stepInput.right = (keys & rightBit) != 0;
+			stepInput.launch = (keys & launchBit) != 0;
+
+			simulation.Step(stepInput);
+
+			nextStep += timeStep;
+			steps++;
+		}
+
+		if (steps == maxCatchUpSteps)
+		{
+			nextStep = now;
+		}
+
+		if (steps > 0)
+		{
+			Publish();
+		}
+
+		std::this_thread::sleep_until(nextStep);
+	}
+}
+
+void SimulationThread::Publish()
+{
+	// assignments reuse the slot's storage, so after the first few snapshots publishing does not allocate
+	RenderSnapshot& snapshot = snapshots.GetWriteBuffer();
+
+	snapshot.state = simulation.GetState();
+	snapshot.score = simulation.GetScore();
+	snapshot.step = simulation.GetStepCount();
+	snapshot.paddle = simulation.GetPaddle();
+	snapshot.balls.assign(simulation.GetBalls().begin(), simulation.GetBalls().end());
+	snapshot.powerUps = simulation.GetPowerUps();
+	snapshot.bricks = simulation.GetBricks();
+
+	snapshots.Publish();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "RenderSnapshot.h"
+#include "Simulation.h"
+#include "TripleBuffer.h"
+
+// Steps a Simulation at its fixed rate on its own thread and publishes a RenderSnapshot after every batch of steps.
+// The render thread only ever reads the latest snapshot, so a slow frame no longer slows the game down
+// and a long step no longer holds up presentation.
+class SimulationThread
+{
+public:
+	// steps the simulation falls behind by before the rest is dropped, a quarter second after a hitch
+	static constexpr unsigned maxCatchUpSteps = 30;
+
+	SimulationThread();
+	~SimulationThread();
+
+	SimulationThread(const SimulationThread&) = delete;
+	SimulationThread& operator=(const SimulationThread&) = delete;
+
+	void Start();
+	void Stop();
+
+	// keys held now, picked up by the next step
+	void SetInput(const SimulationInput& input);
+
+	// the newest published snapshot, valid until the next call. Render thread only
+	const RenderSnapshot& GetLatest();
+
+private:
+	void Run();
+
+	void Publish();
+
+	Simulation simulation;
+	TripleBuffer<RenderSnapshot> snapshots;
+
+	// SimulationInput packed into bits so it can be handed over atomically
+	std::atomic<unsigned> input = 0;
+
+	std::atomic<bool> running = false;
+	std::thread thread;
+};
@@ -0,0 +1,149 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "BatchCollision.h"
+
+void SpatialGrid::Build(const BrickField& bricks, float cellSize)
+{
+	this->cellSize = cellSize;
+
+	glm::vec2 min(0.0f);
+	glm::vec2 max(0.0f);
+
+	for (size_t i = 0; i < bricks.GetSize(); i++)
+	{
+		const glm::vec2 centre(bricks.position[i]);
+		const glm::vec2 extent(bricks.scale[i].x);
+
+		min = i == 0 ? centre - extent : glm::min(min, centre - extent);
+		max = i == 0 ? centre + extent : glm::max(max, centre + extent);
+	}
+
+	origin = min;
+	columns = std::max(1, (int)std::ceil((max.x - min.x) / cellSize));
+	rows = std::max(1, (int)std::ceil((max.y - min.y) / cellSize));
+
+	// visits every cell overlapped by every brick
+	const auto forEachCell = [&](auto&& visit)
+	{
+		for (unsigned i = 0; i < bricks.GetSize(); i++)
+		{
+			const glm::vec2 centre(bricks.position[i]);
+			const glm::vec2 extent(bricks.scale[i].x);
+
+			const glm::ivec2 first = CellOf(centre - extent);
+			const glm::ivec2 last = CellOf(centre + extent);
+
+			for (int y = first.y; y <= last.y; y++)
+			{
+				for (int x = first.x; x <= last.x; x++)
+				{
+					visit(i, y * columns + x);
+				}
+			}
+		}
+	};
+
+	// counting sort of brick indices into their cells
+	cellStart.assign(columns * rows + 1, 0);
+
+	forEachCell([&](unsigned, int cell) { cellStart[cell + 1]++; });
+
+	for (size_t c = 1; c < cellStart.size(); c++)
+	{
+		cellStart[c] += cellStart[c - 1];
+	}
+
+	cellBricks.resize(cellStart.back());
+	std::vector<unsigned> fill(cellStart.begin(), cellStart.end() - 1);
+
+	forEachCell([&](unsigned brick, int cell) { cellBricks[fill[cell]++] = brick; });
+
+	cellMinX.resize(cellBricks.size());
+	cellMinY.resize(cellBricks.size());
+	cellMaxX.resize(cellBricks.size());
+	cellMaxY.resize(cellBricks.size());
+
+	for (size_t i = 0; i < cellBricks.size(); i++)
+	{
+		cellMinX[i] = bricks.minX[cellBricks[i]];
+		cellMinY[i] = bricks.minY[cellBricks[i]];
+		cellMaxX[i] = bricks.maxX[cellBricks[i]];
+		cellMaxY[i] = bricks.maxY[cellBricks[i]];
+	}
+
+	stamps.assign(bricks.GetSize(), 0);
+	stamp = 0;
+}
+
+void SpatialGrid::Query(const glm::vec2& min, const glm::vec2& max, std::vector<unsigned>& result)
+{
+	result.clear();
+
+	if (cellBricks.empty() || max.x < origin.x || max.y < origin.y
+		|| min.x > origin.x + columns * cellSize || min.y > origin.y + rows * cellSize)
+	{
+		return;
+	}
+
+	if (++stamp == 0)
+	{
+		std::fill(stamps.begin(), stamps.end(), 0);
+		stamp = 1;
+	}
+
+	const glm::ivec2 first = CellOf(min);
+	const glm::ivec2 last = CellOf(max);
+
+	for (int y = first.y; y <= last.y; y++)
+	{
+		for (int x = first.x; x <= last.x; x++)
+		{
+			const int cell = y * columns + x;
+			const unsigned start = cellStart[cell];
+
+			const BoxArrays boxes =
+			{
+				cellMinX.data() + start,
+				cellMinY.data() + start,
+				cellMaxX.data() + start,
+				cellMaxY.data() + start,
+				cellStart[cell + 1] - start
+			};
+
+			overlapMask.resize(OverlapMaskWords(boxes.count));
+			OverlapBoxes(min, max, boxes, overlapMask.data());
+
+			for (unsigned word = 0; word < OverlapMaskWords(boxes.count); word++)
+			{
+				for (uint32_t bits = overlapMask[word]; bits != 0; bits &= bits - 1)
+				{
+					const unsigned brick = cellBricks[start + word * 32 + std::countr_zero(bits)];
+
+					if (stamps[brick] != stamp)
+					{
+						stamps[brick] = stamp;
+						result.push_back(brick);
+					}
+				}
+			}
+		}
+	}
+
+	// keep the same hit order as a full scan of the field
+	std::sort(result.begin(), result.end());
+}
+
+glm::ivec2 SpatialGrid::CellOf(const glm::vec2& point) const
+{
+	const glm::vec2 cell = glm::floor((point - origin) / cellSize);
+
+	return glm::ivec2
+	(
+		std::clamp((int)cell.x, 0, columns - 1),
+		std::clamp((int)cell.y, 0, rows - 1)
+	);
+}
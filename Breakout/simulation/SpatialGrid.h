@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "BrickField.h"
+
+// Uniform grid over the brick field used as the collision broad-phase.
+// Cells are stored compactly: cellStart[c]..cellStart[c + 1] indexes the bricks overlapping cell c,
+// and their boxes are copied into the same order so each cell can go to OverlapBoxes as one batch.
+class SpatialGrid
+{
+public:
+	// bricks do not move while they can be hit, so the grid is built once per level
+	void Build(const BrickField& bricks, float cellSize);
+
+	// replaces result with the ascending indices of bricks overlapping the box, the same bricks OverlapBoxes
+	// reports for the whole field, testing only the boxes of the cells the box touches
+	void Query(const glm::vec2& min, const glm::vec2& max, std::vector<unsigned>& result);
+
+private:
+	glm::ivec2 CellOf(const glm::vec2& point) const;
+
+	glm::vec2 origin = glm::vec2(0.0f);
+	float cellSize = 1.0f;
+	int columns = 0;
+	int rows = 0;
+
+	std::vector<unsigned> cellStart;
+	std::vector<unsigned> cellBricks;
+
+	// the bricks' collision boxes in cellBricks order
+	std::vector<float> cellMinX;
+	std::vector<float> cellMinY;
+	std::vector<float> cellMaxX;
+	std::vector<float> cellMaxY;
+
+	std::vector<uint32_t> overlapMask;
+
+	// per brick query stamp so bricks spanning several cells are only reported once
+	std::vector<unsigned> stamps;
+	unsigned stamp = 0;
+};
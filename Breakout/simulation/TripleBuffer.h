@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Hands the latest value from one writer thread to one reader thread without locks or waiting.
+// Each side owns one slot and the third is shared: Publish swaps the writer's filled slot with the shared one,
+// Update swaps the shared one with the reader's when it holds something newer. The reader therefore never
+// sees a slot being written, and a writer running ahead simply replaces values the reader never picked up.
+template <typename T>
+class TripleBuffer
+{
+public:
+	// the slot the writer fills, untouched by the reader until Publish
+	T& GetWriteBuffer() { return slots[writeIndex]; }
+
+	void Publish()
+	{
+		// release hands over the writes to the slot, acquire takes back the one the reader let go of
+		writeIndex = middle.exchange(writeIndex | fresh, std::memory_order_acq_rel) & indexMask;
+	}
+
+	// takes the newest published value, false when nothing was published since the last call
+	bool Update()
+	{
+		if ((middle.load(std::memory_order_relaxed) & fresh) == 0)
+		{
+			return false;
+		}
+
+		readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+
+		return true;
+	}
+
+	// valid until the next Update
+	const T& GetReadBuffer() const { return slots[readIndex]; }
+
+private:
+	// the shared index carries a flag saying the writer stored it and the reader has not taken it yet
+	static constexpr uint8_t indexMask = 0x3;
+	static constexpr uint8_t fresh = 0x4;
+
+	T slots[3];
+
+	std::atomic<uint8_t> middle = 1;
+
+	// each only touched by its own thread
+	uint8_t writeIndex = 0;
+	uint8_t readIndex = 2;
+};
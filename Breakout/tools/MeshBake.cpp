@@ -0,0 +1,75 @@
+// Offline mesh baker: imports a mesh through the same pipeline as MeshCache and writes the result in the
+// baked layout, which the game maps at runtime instead of running Assimp.
+//
+// usage: MeshBake [--compact] [--lods N] <input> [output]
+// the output defaults to BakedMeshPath of the input, next to it, which is where MeshCache looks
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "../models/BakedMesh.h"
+#include "../models/MeshData.h"
+
+int main(int argc, char** argv)
+{
+	VertexFormat format = VertexFormat::Full;
+	unsigned lodLevels = 0;
+	std::string input;
+	std::string output;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--compact") == 0)
+		{
+			format = VertexFormat::Compact;
+		}
+		else if (strcmp(argv[i], "--lods") == 0 && i + 1 < argc)
+		{
+			lodLevels = (unsigned)atoi(argv[++i]);
+		}
+		else if (input.empty())
+		{
+			input = argv[i];
+		}
+		else if (output.empty())
+		{
+			output = argv[i];
+		}
+		else
+		{
+			input.clear();
+			break;
+		}
+	}
+
+	if (input.empty())
+	{
+		std::cout << "usage: MeshBake [--compact] [--lods N] <input> [output]" << std::endl;
+		return 1;
+	}
+
+	if (output.empty())
+	{
+		output = BakedMeshPath(input, format, lodLevels);
+	}
+
+	MeshData mesh;
+
+	if (!ImportMesh(input, format, lodLevels, mesh))
+	{
+		std::cout << "Failed to import " << input << std::endl;
+		return 1;
+	}
+
+	if (!WriteBakedMesh(output, mesh, lodLevels))
+	{
+		return 1;
+	}
+
+	std::cout << "Baked " << input << " -> " << output << ": " << mesh.indices.size() << " indices, "
+		<< mesh.lods.size() << " levels of detail" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,256 @@
+// Headless match runner for build agents: first checks every overlap path the CPU has against the scalar one on
+// random boxes, then plays N seeded matches with a scripted paddle, prints the results for balancing and plays
+// every match a second time to check it replays exactly. Exits with 1 on a path mismatch or if any match diverges.
+//
+// usage: SimulationRunner [matches] [first seed] [bricks wide] [bricks high]
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../simulation/BatchCollision.h"
+#include "../simulation/Simulation.h"
+
+// ten minutes of game time, a match still running then is counted as unfinished
+const unsigned long long maxSteps = (unsigned long long)(600.0f / Simulation::timeStep);
+
+// the trace hashes the whole state every this many steps
+const unsigned traceInterval = 60;
+
+struct MatchResult
+{
+	GameState state;
+	int score;
+	int lives;
+	unsigned long long steps;
+	uint64_t trace;
+};
+
+// random box sets of every size up to this, so each path's batches and tails are all exercised
+const unsigned overlapCheckMaxBoxes = 300;
+
+// queries per box set
+const unsigned overlapCheckQueries = 64;
+
+// coordinates on a quarter unit lattice, so boxes that exactly touch the query come up often
+float LatticeCoordinate(std::mt19937& random, int range)
+{
+	return (float)std::uniform_int_distribution<int>(-4 * range, 4 * range)(random) * 0.25f;
+}
+
+// Returns the number of queries where a path's mask differs from the scalar path's
+unsigned CheckOverlapPaths()
+{
+	const std::vector<OverlapPath> paths = AvailableOverlapPaths();
+	const OverlapPath& scalar = paths.back();
+
+	std::mt19937 random(1);
+	unsigned mismatches = 0;
+
+	std::vector<float> minX, minY, maxX, maxY;
+	std::vector<uint32_t> expected, mask;
+
+	for (unsigned count = 0; count <= overlapCheckMaxBoxes; count++)
+	{
+		minX.resize(count);
+		minY.resize(count);
+		maxX.resize(count);
+		maxY.resize(count);
+
+		for (unsigned i = 0; i < count; i++)
+		{
+			minX[i] = LatticeCoordinate(random, 8);
+			minY[i] = LatticeCoordinate(random, 8);
+			maxX[i] = minX[i] + LatticeCoordinate(random, 1) + 1.0f;
+			maxY[i] = minY[i] + LatticeCoordinate(random, 1) + 1.0f;
+		}
+
+		const BoxArrays boxes = { minX.data(), minY.data(), maxX.data(), maxY.data(), count };
+
+		// one word past the end catches a path writing more words than it should
+		expected.assign(OverlapMaskWords(count) + 1, 0);
+		mask.resize(expected.size());
+
+		for (unsigned query = 0; query < overlapCheckQueries; query++)
+		{
+			const glm::vec2 min(LatticeCoordinate(random, 8), LatticeCoordinate(random, 8));
+			const glm::vec2 max = min + glm::vec2(LatticeCoordinate(random, 2) + 2.0f, LatticeCoordinate(random, 2) + 2.0f);
+
+			scalar.function(min, max, boxes, expected.data());
+
+			for (const OverlapPath& path : paths)
+			{
+				mask.assign(expected.size(), 0);
+				path.function(min, max, boxes, mask.data());
+
+				if (mask != expected)
+				{
+					if (mismatches == 0)
+					{
+						std::cout << "overlap path " << path.name << " differs from scalar on " << count << " boxes" << std::endl;
+					}
+
+					mismatches++;
+				}
+			}
+		}
+	}
+
+	std::cout << "overlap paths checked:";
+
+	for (const OverlapPath& path : paths)
+	{
+		std::cout << " " << path.name;
+	}
+
+	std::cout << ", using " << OverlapBoxesPath() << ", " << mismatches << " mismatches" << std::endl;
+
+	return mismatches;
+}
+
+// FNV-1a, 64 bit
+uint64_t Hash(uint64_t hash, const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ull;
+	}
+
+	return hash;
+}
+
+uint64_t HashState(uint64_t hash, const Simulation& simulation)
+{
+	const PaddleState& paddle = simulation.GetPaddle();
+	hash = Hash(hash, &paddle.position, sizeof(paddle.position));
+
+	const BallPool& balls = simulation.GetBalls();
+
+	for (unsigned i = 0; i < balls.GetCount(); i++)
+	{
+		hash = Hash(hash, &balls[i].position, sizeof(balls[i].position));
+		hash = Hash(hash, &balls[i].velocity, sizeof(balls[i].velocity));
+	}
+
+	const BrickField& bricks = simulation.GetBricks();
+	hash = Hash(hash, bricks.alive.data(), bricks.alive.size());
+
+	const int score = simulation.GetScore();
+
+	return Hash(hash, &score, sizeof(score));
+}
+
+// follows the lowest ball, with a dead zone that depends on the seed so the matches play out differently
+MatchResult PlayMatch(uint32_t seed, unsigned bricksWide, unsigned bricksHigh)
+{
+	Simulation simulation(seed, bricksWide, bricksHigh);
+
+	const float deadZone = 0.2f + (seed % 8) * 0.15f;
+	uint64_t trace = 0xCBF29CE484222325ull;
+
+	SimulationInput input;
+	input.launch = true;
+
+	while (simulation.GetState() == GameState::Play && simulation.GetStepCount() < maxSteps)
+	{
+		const BallPool& balls = simulation.GetBalls();
+		const PaddleState& paddle = simulation.GetPaddle();
+
+		input.left = false;
+		input.right = false;
+
+		if (balls.GetCount() > 0)
+		{
+			const BallState* lowest = &balls[0];
+
+			for (unsigned i = 1; i < balls.GetCount(); i++)
+			{
+				if (balls[i].position.y < lowest->position.y)
+				{
+					lowest = &balls[i];
+				}
+			}
+
+			input.left = lowest->position.x < paddle.position.x - deadZone;
+			input.right = lowest->position.x > paddle.position.x + deadZone;
+		}
+
+		simulation.Step(input);
+
+		if (simulation.GetStepCount() % traceInterval == 0)
+		{
+			trace = HashState(trace, simulation);
+		}
+	}
+
+	return { simulation.GetState(), simulation.GetScore(), simulation.GetPaddle().lives, simulation.GetStepCount(), HashState(trace, simulation) };
+}
+
+int main(int argc, char** argv)
+{
+	const unsigned matches = argc > 1 ? (unsigned)atoi(argv[1]) : 1000;
+	const uint32_t firstSeed = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 0) : 1;
+	const unsigned bricksWide = argc > 3 ? (unsigned)atoi(argv[3]) : Simulation::defaultBricksWide;
+	const unsigned bricksHigh = argc > 4 ? (unsigned)atoi(argv[4]) : Simulation::defaultBricksHigh;
+
+	if (CheckOverlapPaths() > 0)
+	{
+		return 1;
+	}
+
+	unsigned wins = 0;
+	unsigned losses = 0;
+	unsigned unfinished = 0;
+	unsigned diverged = 0;
+	long long totalScore = 0;
+	unsigned long long totalSteps = 0;
+
+	for (unsigned match = 0; match < matches; match++)
+	{
+		const uint32_t seed = firstSeed + match;
+
+		const MatchResult result = PlayMatch(seed, bricksWide, bricksHigh);
+		const MatchResult replay = PlayMatch(seed, bricksWide, bricksHigh);
+
+		if (result.state != replay.state || result.score != replay.score || result.steps != replay.steps || result.trace != replay.trace)
+		{
+			std::cout << "seed " << seed << " diverged on replay: score " << result.score << " vs " << replay.score
+				<< ", steps " << result.steps << " vs " << replay.steps << std::endl;
+			diverged++;
+		}
+
+		if (result.state == GameState::Win)
+		{
+			wins++;
+		}
+		else if (result.state == GameState::Lose)
+		{
+			losses++;
+		}
+		else
+		{
+			unfinished++;
+		}
+
+		totalScore += result.score;
+		totalSteps += result.steps;
+	}
+
+	std::cout << matches << " matches from seed " << firstSeed << " on " << bricksWide << "x" << bricksHigh << " bricks: " << wins << " won, " << losses << " lost, "
+		<< unfinished << " unfinished, average score " << (matches ? (double)totalScore / matches : 0.0)
+		<< ", average length " << (matches ? totalSteps * Simulation::timeStep / matches : 0.0) << " s" << std::endl;
+
+	if (diverged > 0)
+	{
+		std::cout << diverged << " matches did not replay exactly" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,120 @@
+// Stress test for the hand-off between the simulation thread and the renderer, meant to run under ThreadSanitizer
+// (configure with -fsanitize=thread). A writer publishes numbered blocks through a TripleBuffer while the reader
+// checks that it never sees a half written block or an older one after a newer; then a running SimulationThread
+// is read as fast as possible for a second. Exits with 1 on any bad read.
+//
+// usage: TripleBufferStress [publishes]
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "../simulation/SimulationThread.h"
+#include "../simulation/TripleBuffer.h"
+
+// large enough that a torn copy would show up as mixed values
+struct Block
+{
+	unsigned long long values[64];
+};
+
+bool StressTripleBuffer(unsigned long long publishes)
+{
+	TripleBuffer<Block> buffer;
+	std::atomic<bool> done = false;
+
+	std::thread writer([&]
+	{
+		for (unsigned long long i = 1; i <= publishes; i++)
+		{
+			Block& block = buffer.GetWriteBuffer();
+
+			for (unsigned long long& value : block.values)
+			{
+				value = i;
+			}
+
+			buffer.Publish();
+		}
+
+		done = true;
+	});
+
+	unsigned long long last = 0;
+	unsigned long long updates = 0;
+	unsigned long long torn = 0;
+	unsigned long long backwards = 0;
+
+	// one more Update after the writer is done picks up its last publish
+	for (bool finished = false; !finished; )
+	{
+		finished = done;
+
+		if (!buffer.Update())
+		{
+			continue;
+		}
+
+		const Block& block = buffer.GetReadBuffer();
+
+		for (unsigned long long value : block.values)
+		{
+			torn += value != block.values[0];
+		}
+
+		backwards += block.values[0] < last;
+		last = block.values[0];
+		updates++;
+	}
+
+	writer.join();
+
+	std::cout << "TripleBuffer: " << publishes << " publishes, " << updates << " reads, " << torn << " torn, "
+		<< backwards << " out of order, last " << last << std::endl;
+
+	return torn == 0 && backwards == 0 && last == publishes;
+}
+
+bool StressSimulationThread()
+{
+	SimulationThread simulation;
+	simulation.Start();
+
+	SimulationInput input;
+	input.launch = true;
+	simulation.SetInput(input);
+
+	unsigned long long last = 0;
+	unsigned long long reads = 0;
+	unsigned long long bad = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	while (std::chrono::steady_clock::now() - start < std::chrono::seconds(1))
+	{
+		const RenderSnapshot& snapshot = simulation.GetLatest();
+
+		bad += snapshot.step < last || snapshot.bricks.GetSize() != Simulation::defaultBricksHigh * Simulation::defaultBricksWide;
+		last = snapshot.step;
+		reads++;
+	}
+
+	simulation.Stop();
+
+	std::cout << "SimulationThread: " << reads << " reads over one second, " << bad << " bad, reached step " << last << std::endl;
+
+	// a second at 120 steps per second should reach 120, half of that leaves room for a slow or sanitized build
+	return bad == 0 && last >= 60;
+}
+
+int main(int argc, char** argv)
+{
+	const unsigned long long publishes = argc > 1 ? strtoull(argv[1], nullptr, 0) : 2000000;
+
+	const bool bufferPassed = StressTripleBuffer(publishes);
+	const bool threadPassed = StressSimulationThread();
+
+	return bufferPassed && threadPassed ? 0 : 1;
+}